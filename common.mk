@@ -68,6 +68,26 @@ ML_PROFILER_CPU=cm55
 # Choose the source of regression data for validation
 # stream - regression data is streamed from the ML configurator
 # local - regression data is stored locally in the project
+# pipeline - regression data is streamed with the pipelined protocol from
+#            tools/ml_stream_host.py (the next samples are received during the
+#            current inference)
 ML_VALIDATION_SOURCE=stream
 
+# Choose the format of the local regression inputs (x data)
+# full - samples as generated by the ML configurator
+# compressed - samples compressed with tools/x_data_compress.py, decompressed
+#              one at a time before each inference
+ML_X_DATA_FORMAT=full
+
+# Choose the format of the local regression outputs (y data)
+# full - output vector of every sample, as generated by the ML configurator
+# labels - class of every sample only, converted from the full y data with
+#          tools/y_data_to_labels.py
+ML_Y_DATA_FORMAT=full
+
+# Record the profiling events (inference, operator, stream RX/TX) in a binary
+# trace buffer, dumped in one burst at the end of the run. Decode the dump with
+# tools/trace_decode.py - yes or no
+ML_TRACE=no
+
 include ../common_app.mk
@@ -27,7 +27,34 @@
 SOURCES+=$(wildcard ../shared_src/*.c)
 INCLUDES+=../shared_src/
 
+# Register the tensor arena of the interpreter-less model for the memory report
+DEFINES+=ML_MEM_USAGE=1
+
 # Add where to source the regression data from
 ifeq (stream, $(ML_VALIDATION_SOURCE))
 	DEFINES+=USE_STREAM_DATA
 endif
+ifeq (pipeline, $(ML_VALIDATION_SOURCE))
+	DEFINES+=USE_STREAM_DATA ML_STREAM_PIPELINE
+endif
+
+# Compare the local regression results to the label-only y data
+ifeq (labels, $(ML_Y_DATA_FORMAT))
+	DEFINES+=ML_Y_DATA_LABELS
+endif
+
+# Decompress the local regression inputs one sample at a time
+ifeq (compressed, $(ML_X_DATA_FORMAT))
+	DEFINES+=ML_X_DATA_COMPRESSED
+endif
+
+# Add the binary trace buffer
+ifeq (yes, $(ML_TRACE))
+	DEFINES+=ML_TRACE
+endif
+
+# Track the heap usage by wrapping the C allocator (GNU linker only)
+ifeq ($(TOOLCHAIN), GCC_ARM)
+	LDFLAGS+=-Wl,--wrap=malloc,--wrap=free,--wrap=calloc,--wrap=realloc
+	DEFINES+=ML_HEAP_TRACKING
+endif
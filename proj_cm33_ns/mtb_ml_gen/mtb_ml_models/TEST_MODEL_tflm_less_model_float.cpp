@@ -11,6 +11,12 @@
 #if LOG_OP_INPUTS
 #include "tensorflow/lite/micro/micro_invoke_log.h"
 #endif
+#if ML_PROFILE_OPS
+#include "op_profiler.h"
+#endif
+#if ML_MEM_USAGE
+#include "mem_usage.h"
+#endif
 
 namespace tflite {
   class MicroGraph;
@@ -61,6 +67,12 @@ enum used_operators_e {
   OP_FULLY_CONNECTED, OP_SOFTMAX,  OP_LAST
 };
 
+#if ML_PROFILE_OPS
+const char * const used_operator_names[OP_LAST] = {
+  "FULLY_CONNECTED", "SOFTMAX", 
+};
+#endif
+
 
 struct TensorInfo_t { // subset of TfLiteTensor used for initialization from constant memory
   void* data;
@@ -437,7 +449,49 @@ protected:
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
 
+#if ML_PROFILE_OPS
+// Reports the MAC count and the weight/activation bytes of each node
+// to the operator profiler.
+static void DescribeNodesForProfiler() {
+  for(size_t i = 0; i < kOpNodesCount; ++i) {
+    const TfLiteIntArray* inputs = nodeData[i].inputs;
+    const TfLiteIntArray* outputs = nodeData[i].outputs;
+    uint32_t weight_bytes = 0;
+    uint32_t activation_bytes = 0;
+    uint64_t macs = 0;
+    for(int j = 0; j < inputs->size; ++j) {
+      if (inputs->data[j] < 0) {
+        continue;
+      }
+      const TfLiteTensor& tensor = tflTensors[inputs->data[j]];
+      if (tensor.allocation_type == kTfLiteMmapRo) {
+        weight_bytes += tensor.bytes;
+      } else {
+        activation_bytes += tensor.bytes;
+      }
+    }
+    for(int j = 0; j < outputs->size; ++j) {
+      activation_bytes += tflTensors[outputs->data[j]].bytes;
+    }
+    if (nodeData[i].used_op_index == OP_FULLY_CONNECTED) {
+      // One MAC per output element and per weight column
+      const TfLiteIntArray* out_dims = tflTensors[outputs->data[0]].dims;
+      const TfLiteIntArray* weight_dims = tflTensors[inputs->data[1]].dims;
+      uint64_t out_elements = 1;
+      for(int d = 0; d < out_dims->size; ++d) {
+        out_elements *= out_dims->data[d];
+      }
+      macs = out_elements * weight_dims->data[weight_dims->size - 1];
+    }
+    op_profiler_set_node_info(i, macs, weight_bytes, activation_bytes);
+  }
+}
+#endif
+
 extern "C" TfLiteStatus TEST_MODEL_init() {
+#if ML_MEM_USAGE
+  mem_usage_register_arena(tensor_arena, sizeof(tensor_arena));
+#endif
   head_ptr = tensor_arena ;
   tail_ptr = tensor_arena + sizeof(tensor_arena);
   ctx.AllocatePersistentBuffer = &AllocatePersistentBuffer;
@@ -499,6 +553,9 @@ tflite::micro::resetOfflineOpUserData( tflite::micro::TEST_MODEL_model::precompu
     }
     precomputed_sb_idx_ctr += node_scratch_buffer_requests[i];
   }
+#if ML_PROFILE_OPS
+  DescribeNodesForProfiler();
+#endif
   return kTfLiteOk;
 }
 
@@ -563,8 +620,14 @@ tflite::micro::resetOfflineOpUserData( tflite::micro::TEST_MODEL_model::precompu
   for(size_t i = 0; i < kOpNodesCount; ++i) {
 #if LOG_OP_INPUTS
     tflite::logOpInvoke(&ctx,  &tflNodes[i]);
+#endif
+#if ML_PROFILE_OPS
+    op_profiler_node_begin(i);
 #endif
     TfLiteStatus status = registrations[nodeData[i].used_op_index].invoke(&ctx, &tflNodes[i]);
+#if ML_PROFILE_OPS
+    op_profiler_node_end(i, used_operator_names[nodeData[i].used_op_index]);
+#endif
     if (status != kTfLiteOk) {
       return status;
     }
@@ -47,6 +47,7 @@
 #ifdef ML_PROFILER_CM55
 #include "ml_validation.h"
 #include "elapsed_timer.h"
+#include "stack_usage.h"
 #include "app_common.h"
 
 #include MTB_ML_INCLUDE_MODEL_FILE(MODEL_NAME)
@@ -101,12 +102,15 @@ static void cm55_ml_profiler_task(void * arg)
     cy_rslt_t result;
     CY_UNUSED_PARAMETER(arg);
 
+    /* Paint the main stack to measure its peak depth */
+    stack_usage_register_main("cm55_ml_profiler_task");
+
     mtb_ml_model_bin_t model_bin = {MTB_ML_MODEL_BIN_DATA(MODEL_NAME)};
 
     /* Initialize retarget-io to use the debug UART port */
     app_retarget_io_init(UART_DEFAULT_STREAM_BAUD_RATE);
 
-#if USE_STREAM_DATA
+#if defined(USE_STREAM_DATA) && !defined(ML_STREAM_PIPELINE)
     /* Data streaming object */
     mtb_data_streaming_interface_t data_stream_obj;
     mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *) &(data_stream_obj.context);
@@ -130,26 +134,29 @@ static void cm55_ml_profiler_task(void * arg)
     /* Initialize the ModusToolbox ML middleware */
     mtb_ml_init(MTB_ML_PRIORITY);
 
-    result = ml_validation_init(PROFILE_CONFIGURATION, &model_bin);
+    /* Initialize the elapsed timer before the model: the middleware reads it
+     * through mtb_ml_model_profile_get_tsc() */
+    result = elapsed_timer_init();
 
     if(CY_RSLT_SUCCESS != result)
     {
-        printf("ERROR: initialization of the ML validation failed!\r\n");
+        printf("ERROR: initialization of elapsed timer failed!\r\n");
         handle_error();
     }
 
-    /* Initialize the elapsed timer */
-    result = elapsed_timer_init();
+    result = ml_validation_init(PROFILE_CONFIGURATION, &model_bin);
 
     if(CY_RSLT_SUCCESS != result)
     {
-        printf("ERROR: initialization of elapsed timer failed!\r\n");
+        printf("ERROR: initialization of the ML validation failed!\r\n");
         handle_error();
     }
 
     for (;;)
     {
-#if USE_STREAM_DATA
+#if defined(ML_STREAM_PIPELINE)
+        result = ml_validation_pipeline_task();
+#elif USE_STREAM_DATA
         result = ml_validation_stream_task(&stream_interface);
 #else
         result = ml_validation_local_task();
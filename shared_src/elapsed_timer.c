@@ -40,8 +40,15 @@
 *******************************************************************************/
 #include <stdio.h>
 
+#if defined(ML_PROFILER_HOST)
+#include <time.h>
+#if defined(ELAPSED_TIMER_HOST_RDTSC)
+#include <x86intrin.h>
+#endif
+#else
 #include "cybsp.h"
 #include "cy_pdl.h"
+#endif
 
 #include "elapsed_timer.h"
 
@@ -51,12 +58,43 @@
 #define SYSTICK_MAX_CNT (0xFFFFFF)
 #define RESET_VAL       (0u)
 
+/* Number of cycles to wait when checking that the DWT cycle counter runs */
+#define DWT_CHECK_CYCLES (100u)
+
+/* Number of back-to-back reads used to calibrate the timer overhead */
+#define CALIBRATION_READS (31u)
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    bool (*init)(void);
+    uint64_t (*read)(void);
+} elapsed_timer_source_t;
+
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
+#if !defined(ML_PROFILER_HOST)
 /* System Tick overflow counter */
-static volatile uint64_t elapsed_timer_ov = RESET_VAL;
+static volatile uint32_t elapsed_timer_ov = RESET_VAL;
 
+#if (ELAPSED_TIMER_SOURCE == ELAPSED_TIMER_SOURCE_DWT)
+/* DWT cycle counter extended to 64 bits */
+static elapsed_timer_ext_t elapsed_timer_dwt;
+#endif
+#endif /* ML_PROFILER_HOST */
+
+/* Clock source in use */
+static const elapsed_timer_source_t *elapsed_timer_source;
+
+/* Cost of an empty measured region (two back-to-back reads) */
+static uint64_t elapsed_timer_overhead_min = RESET_VAL;
+static uint64_t elapsed_timer_overhead_median = RESET_VAL;
+
+#if !defined(ML_PROFILER_HOST)
 /*******************************************************************************
 * Function Name: elapsed_timer_callback
 ********************************************************************************
@@ -77,19 +115,19 @@ static void elapsed_timer_callback(void)
 }
 
 /*******************************************************************************
-* Function Name: elapsed_timer_init
+* Function Name: elapsed_timer_systick_init
 ********************************************************************************
 * Summary:
-*   Initialize the elapsed system tick timer.
+*   Start the System Tick and count its overflows in an interrupt.
 *
 * Parameters:
 *   void
 *
 * Return:
-*   cy_rslt_t: the status of the initialization.
+*   bool: true if the clock source is available.
 *
 *******************************************************************************/
-cy_rslt_t elapsed_timer_init(void)
+static bool elapsed_timer_systick_init(void)
 {
     /* Initialize the System Tick */
     Cy_SysTick_Init(CY_SYSTICK_CLOCK_SOURCE_CLK_CPU, SYSTICK_MAX_CNT);
@@ -97,6 +135,267 @@ cy_rslt_t elapsed_timer_init(void)
 
     elapsed_timer_ov = RESET_VAL;
 
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: elapsed_timer_systick_read
+********************************************************************************
+* Summary:
+*   Combine the System Tick value with the overflow counter. The read is
+*   retried if an overflow interrupt ran in between, and a pending overflow
+*   (interrupts masked) is accounted for.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   uint64_t: number of CPU cycles since the timer was started.
+*
+*******************************************************************************/
+static uint64_t elapsed_timer_systick_read(void)
+{
+    uint32_t ov;
+    uint32_t value;
+
+    do
+    {
+        ov = elapsed_timer_ov;
+        value = Cy_SysTick_GetValue();
+
+        if (0u != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+        {
+            /* The counter wrapped, but the callback has not run yet */
+            value = Cy_SysTick_GetValue();
+            ov++;
+        }
+    } while (ov != elapsed_timer_ov);
+
+    return (SYSTICK_MAX_CNT - (uint64_t) value) + ((uint64_t) ov * (SYSTICK_MAX_CNT+1));
+}
+
+static const elapsed_timer_source_t elapsed_timer_systick_source =
+{
+    .name = "SysTick",
+    .init = elapsed_timer_systick_init,
+    .read = elapsed_timer_systick_read,
+};
+
+#if (ELAPSED_TIMER_SOURCE == ELAPSED_TIMER_SOURCE_DWT)
+/*******************************************************************************
+* Function Name: elapsed_timer_dwt_init
+********************************************************************************
+* Summary:
+*   Enable the DWT cycle counter and check that it runs. It may be missing or
+*   not accessible from the current security state.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   bool: true if the clock source is available.
+*
+*******************************************************************************/
+static bool elapsed_timer_dwt_init(void)
+{
+    uint32_t start;
+
+#if defined(DCB)
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#else
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#endif
+
+    if (0u != (DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk))
+    {
+        return false;
+    }
+
+    DWT->CYCCNT = RESET_VAL;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    start = DWT->CYCCNT;
+    Cy_SysLib_DelayCycles(DWT_CHECK_CYCLES);
+    if (DWT->CYCCNT == start)
+    {
+        return false;
+    }
+
+    elapsed_timer_dwt.last = DWT->CYCCNT;
+    elapsed_timer_dwt.high = RESET_VAL;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: elapsed_timer_dwt_read
+********************************************************************************
+* Summary:
+*   Extend the 32-bit DWT cycle counter to 64 bits.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   uint64_t: number of CPU cycles since the timer was started.
+*
+*******************************************************************************/
+static uint64_t elapsed_timer_dwt_read(void)
+{
+    uint32_t irq_state = Cy_SysLib_EnterCriticalSection();
+    uint64_t tick = elapsed_timer_extend(&elapsed_timer_dwt, DWT->CYCCNT);
+
+    Cy_SysLib_ExitCriticalSection(irq_state);
+
+    return tick;
+}
+
+static const elapsed_timer_source_t elapsed_timer_dwt_source =
+{
+    .name = "DWT CYCCNT",
+    .init = elapsed_timer_dwt_init,
+    .read = elapsed_timer_dwt_read,
+};
+#endif /* ELAPSED_TIMER_SOURCE_DWT */
+
+#else
+/*******************************************************************************
+* Function Name: elapsed_timer_host_init
+********************************************************************************
+* Summary:
+*   Nothing to initialize, the host clocks are always running.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   bool: true if the clock source is available.
+*
+*******************************************************************************/
+static bool elapsed_timer_host_init(void)
+{
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: elapsed_timer_host_read
+********************************************************************************
+* Summary:
+*   Read the host time stamp counter or the monotonic clock.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   uint64_t: TSC cycles or nanoseconds.
+*
+*******************************************************************************/
+static uint64_t elapsed_timer_host_read(void)
+{
+#if defined(ELAPSED_TIMER_HOST_RDTSC)
+    return (uint64_t) __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t) ts.tv_sec * 1000000000u) + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+static const elapsed_timer_source_t elapsed_timer_host_source =
+{
+#if defined(ELAPSED_TIMER_HOST_RDTSC)
+    .name = "TSC",
+#else
+    .name = "CLOCK_MONOTONIC (ns)",
+#endif
+    .init = elapsed_timer_host_init,
+    .read = elapsed_timer_host_read,
+};
+#endif /* ML_PROFILER_HOST */
+
+/*******************************************************************************
+* Function Name: elapsed_timer_calibrate
+********************************************************************************
+* Summary:
+*   Measure the cost of an empty region, i.e. two back-to-back calls to
+*   elapsed_timer_get_tick(), and keep its min and median values.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*
+*******************************************************************************/
+static void elapsed_timer_calibrate(void)
+{
+    uint64_t samples[CALIBRATION_READS];
+    uint64_t start;
+    uint64_t end;
+
+    for (uint32_t i = 0; i < CALIBRATION_READS; i++)
+    {
+        elapsed_timer_get_tick(&start);
+        elapsed_timer_get_tick(&end);
+        samples[i] = end - start;
+    }
+
+    /* Sort the samples (insertion sort) */
+    for (uint32_t i = 1; i < CALIBRATION_READS; i++)
+    {
+        uint64_t value = samples[i];
+        uint32_t j = i;
+
+        while ((j > 0) && (samples[j - 1] > value))
+        {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        samples[j] = value;
+    }
+
+    elapsed_timer_overhead_min = samples[0];
+    elapsed_timer_overhead_median = samples[CALIBRATION_READS / 2];
+}
+
+/*******************************************************************************
+* Function Name: elapsed_timer_init
+********************************************************************************
+* Summary:
+*   Initialize the clock source selected by ELAPSED_TIMER_SOURCE. If the DWT
+*   cycle counter is not available, the System Tick is used instead. Then
+*   calibrate the overhead of the timer.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   cy_rslt_t: the status of the initialization.
+*
+*******************************************************************************/
+cy_rslt_t elapsed_timer_init(void)
+{
+#if (ELAPSED_TIMER_SOURCE == ELAPSED_TIMER_SOURCE_HOST)
+    elapsed_timer_source = &elapsed_timer_host_source;
+#elif (ELAPSED_TIMER_SOURCE == ELAPSED_TIMER_SOURCE_DWT)
+    elapsed_timer_source = &elapsed_timer_dwt_source;
+#else
+    elapsed_timer_source = &elapsed_timer_systick_source;
+#endif
+
+    if (!elapsed_timer_source->init())
+    {
+#if (ELAPSED_TIMER_SOURCE == ELAPSED_TIMER_SOURCE_DWT)
+        /* Fall back to the System Tick */
+        elapsed_timer_source = &elapsed_timer_systick_source;
+        (void) elapsed_timer_source->init();
+#endif
+    }
+
+    elapsed_timer_calibrate();
+
     return CY_RSLT_SUCCESS;
 }
 
@@ -105,6 +404,8 @@ cy_rslt_t elapsed_timer_init(void)
 ********************************************************************************
 * Summary:
 *   Return the current tick (number of CPU cycles) since the timer was started.
+*   It is also the time stamp counter of the ML middleware, so call
+*   elapsed_timer_init() before initializing a model.
 *
 * Parameters:
 *   tick: current number of ticks.
@@ -115,8 +416,106 @@ cy_rslt_t elapsed_timer_init(void)
 *******************************************************************************/
 int elapsed_timer_get_tick(uint64_t *tick)
 {
-    *tick = (SYSTICK_MAX_CNT - (uint64_t) Cy_SysTick_GetValue()) + (elapsed_timer_ov * (SYSTICK_MAX_CNT+1));
-    
+    *tick = elapsed_timer_source->read();
+
     return CY_RSLT_SUCCESS;
 }
 
+/*******************************************************************************
+* Function Name: elapsed_timer_get_source_name
+********************************************************************************
+* Summary:
+*   Return the name of the clock source in use.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   const char *: name of the clock source.
+*
+*******************************************************************************/
+const char *elapsed_timer_get_source_name(void)
+{
+    return (elapsed_timer_source != NULL) ? elapsed_timer_source->name : "none";
+}
+
+/*******************************************************************************
+* Function Name: elapsed_timer_get_frequency
+********************************************************************************
+* Summary:
+*   Return the frequency of the ticks.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   uint32_t: number of ticks per second, or 0 if unknown.
+*
+*******************************************************************************/
+uint32_t elapsed_timer_get_frequency(void)
+{
+#if defined(ML_PROFILER_HOST)
+#if defined(ELAPSED_TIMER_HOST_RDTSC)
+    return 0u;
+#else
+    return 1000000000u;
+#endif
+#else
+    /* Both the DWT and System Tick count CPU cycles */
+    return SystemCoreClock;
+#endif /* ML_PROFILER_HOST */
+}
+
+/*******************************************************************************
+* Function Name: elapsed_timer_extend
+********************************************************************************
+* Summary:
+*   Extend a 32-bit counter to 64 bits. A wrap is detected when the counter is
+*   lower than on the previous read, so it must be read at least once per
+*   wrap. It does not touch the hardware, so it can be checked on the host.
+*
+* Parameters:
+*   ext: state of the extended counter
+*   now: current value of the 32-bit counter
+*
+* Return:
+*   uint64_t: extended counter value.
+*
+*******************************************************************************/
+uint64_t elapsed_timer_extend(elapsed_timer_ext_t *ext, uint32_t now)
+{
+    if (now < ext->last)
+    {
+        ext->high++;
+    }
+    ext->last = now;
+
+    return ((uint64_t) ext->high << 32) | now;
+}
+
+/*******************************************************************************
+* Function Name: elapsed_timer_get_overhead
+********************************************************************************
+* Summary:
+*   Return the number of ticks added to a measured region by the two calls to
+*   elapsed_timer_get_tick(), as calibrated in elapsed_timer_init().
+*
+* Parameters:
+*   min: returns the minimum overhead (can be NULL)
+*   median: returns the median overhead (can be NULL)
+*
+* Return:
+*   void
+*
+*******************************************************************************/
+void elapsed_timer_get_overhead(uint64_t *min, uint64_t *median)
+{
+    if (min != NULL)
+    {
+        *min = elapsed_timer_overhead_min;
+    }
+    if (median != NULL)
+    {
+        *median = elapsed_timer_overhead_median;
+    }
+}
@@ -42,7 +42,11 @@
 #ifndef ELAPSED_TIMER_H
 #define ELAPSED_TIMER_H
 
+#if defined(ML_PROFILER_HOST)
+#include "host_compat.h"
+#else
 #include "cy_result.h"
+#endif
 
 
 /*******************************************************************************
@@ -50,11 +54,44 @@
 *******************************************************************************/
 #define elapsed_timer_get_tick mtb_ml_model_profile_get_tsc
 
+/* Clock sources of the elapsed timer:
+ * - SYSTICK: 24-bit SysTick extended by an overflow interrupt
+ * - DWT:     32-bit DWT cycle counter extended on read (no interrupt). The
+ *            timer must be read at least once every 2^32 CPU cycles.
+ * - HOST:    clock_gettime() in nanoseconds, or the TSC when
+ *            ELAPSED_TIMER_HOST_RDTSC is defined (x86 only)
+ */
+#define ELAPSED_TIMER_SOURCE_SYSTICK    (0u)
+#define ELAPSED_TIMER_SOURCE_DWT        (1u)
+#define ELAPSED_TIMER_SOURCE_HOST       (2u)
+
+#ifndef ELAPSED_TIMER_SOURCE
+#if defined(ML_PROFILER_HOST)
+#define ELAPSED_TIMER_SOURCE            ELAPSED_TIMER_SOURCE_HOST
+#else
+#define ELAPSED_TIMER_SOURCE            ELAPSED_TIMER_SOURCE_DWT
+#endif
+#endif
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+/* 32-bit counter extended to 64 bits on read (DWT source) */
+typedef struct
+{
+    uint32_t last; /* Counter value of the previous read */
+    uint32_t high; /* Number of wraps seen */
+} elapsed_timer_ext_t;
+
 /*******************************************************************************
 * Functions
 *******************************************************************************/
 cy_rslt_t elapsed_timer_init(void);
 int elapsed_timer_get_tick(uint64_t *tick);
+const char *elapsed_timer_get_source_name(void);
+uint32_t elapsed_timer_get_frequency(void);
+void elapsed_timer_get_overhead(uint64_t *min, uint64_t *median);
+uint64_t elapsed_timer_extend(elapsed_timer_ext_t *ext, uint32_t now);
 
 #endif /* ELAPSED_TIMER_H */
 
@@ -0,0 +1,292 @@
+/******************************************************************************
+* File Name:   latency_histogram.c
+*
+* Description: This file contains the implementation of a fixed-memory,
+*              log-bucketed latency histogram.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "latency_histogram.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+/* Values above this limit are counted in the last bucket */
+#define LATENCY_HISTOGRAM_MAX_VALUE     (0xFFFFFFFFu)
+
+/*******************************************************************************
+* Function Name: latency_histogram_msb
+********************************************************************************
+* Summary:
+*   Return the position of the most significant bit set in a non-zero value.
+*
+* Parameters:
+*   value: non-zero value
+*
+* Return:
+*   uint32_t: bit position (0 to 31)
+*******************************************************************************/
+static uint32_t latency_histogram_msb(uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 31u - (uint32_t) __builtin_clz(value);
+#else
+    uint32_t msb = 0;
+
+    while ((value >>= 1) != 0)
+    {
+        msb++;
+    }
+
+    return msb;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: latency_histogram_bucket_index
+********************************************************************************
+* Summary:
+*   Map a value to its bucket. Values smaller than the number of sub-buckets
+*   have their own bucket; larger values are placed by power-of-two range and
+*   the next LATENCY_HISTOGRAM_SUB_BITS bits below the leading one.
+*
+* Parameters:
+*   value: latency value
+*
+* Return:
+*   uint32_t: bucket index
+*******************************************************************************/
+static uint32_t latency_histogram_bucket_index(uint32_t value)
+{
+    uint32_t msb;
+    uint32_t sub;
+
+    if (value < LATENCY_HISTOGRAM_SUB_BUCKETS)
+    {
+        return value;
+    }
+
+    msb = latency_histogram_msb(value);
+    sub = (value >> (msb - LATENCY_HISTOGRAM_SUB_BITS)) - LATENCY_HISTOGRAM_SUB_BUCKETS;
+
+    return (LATENCY_HISTOGRAM_SUB_BUCKETS * (msb - LATENCY_HISTOGRAM_SUB_BITS + 1u)) + sub;
+}
+
+/*******************************************************************************
+* Function Name: latency_histogram_bucket_lower
+********************************************************************************
+* Summary:
+*   Return the smallest value that maps to the given bucket.
+*
+* Parameters:
+*   index: bucket index
+*   width: returns the number of values covered by the bucket
+*
+* Return:
+*   uint64_t: lower bound of the bucket
+*******************************************************************************/
+static uint64_t latency_histogram_bucket_lower(uint32_t index, uint64_t *width)
+{
+    uint32_t range = index / LATENCY_HISTOGRAM_SUB_BUCKETS;
+    uint32_t sub = index % LATENCY_HISTOGRAM_SUB_BUCKETS;
+
+    if (range == 0)
+    {
+        *width = 1;
+        return index;
+    }
+
+    *width = ((uint64_t) 1u) << (range - 1u);
+    return ((uint64_t) (LATENCY_HISTOGRAM_SUB_BUCKETS + sub)) << (range - 1u);
+}
+
+/*******************************************************************************
+* Function Name: latency_histogram_reset
+********************************************************************************
+* Summary:
+*   Clear all the samples of a histogram.
+*
+* Parameters:
+*   hist: pointer to the histogram
+*
+* Return:
+*   void
+*******************************************************************************/
+void latency_histogram_reset(latency_histogram_t *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->min = UINT64_MAX;
+}
+
+/*******************************************************************************
+* Function Name: latency_histogram_record
+********************************************************************************
+* Summary:
+*   Add one latency sample to the histogram.
+*
+* Parameters:
+*   hist: pointer to the histogram
+*   value: latency (e.g. number of cycles)
+*
+* Return:
+*   void
+*******************************************************************************/
+void latency_histogram_record(latency_histogram_t *hist, uint64_t value)
+{
+    uint32_t clamped = (value > LATENCY_HISTOGRAM_MAX_VALUE) ?
+                       LATENCY_HISTOGRAM_MAX_VALUE : (uint32_t) value;
+
+    hist->buckets[latency_histogram_bucket_index(clamped)]++;
+    hist->count++;
+    hist->sum += value;
+
+    if (value < hist->min)
+    {
+        hist->min = value;
+    }
+    if (value > hist->max)
+    {
+        hist->max = value;
+    }
+}
+
+/*******************************************************************************
+* Function Name: latency_histogram_percentile
+********************************************************************************
+* Summary:
+*   Estimate the value below which the given percentage of samples fall. The
+*   value is interpolated inside the bucket and clamped to the observed
+*   min/max values.
+*
+* Parameters:
+*   hist: pointer to the histogram
+*   percentile: percentile to estimate (0.0 to 100.0)
+*
+* Return:
+*   uint64_t: estimated value, or 0 if the histogram is empty
+*******************************************************************************/
+uint64_t latency_histogram_percentile(const latency_histogram_t *hist, float percentile)
+{
+    uint64_t rank;
+    uint64_t cumulative = 0;
+
+    if (hist->count == 0)
+    {
+        return 0;
+    }
+
+    /* Rank of the sample (1-based) holding the percentile */
+    rank = (uint64_t) ((percentile * (float) hist->count) / 100.0f + 0.999f);
+    if (rank < 1u)
+    {
+        rank = 1u;
+    }
+    if (rank > hist->count)
+    {
+        rank = hist->count;
+    }
+
+    for (uint32_t i = 0; i < LATENCY_HISTOGRAM_NUM_BUCKETS; i++)
+    {
+        uint32_t bucket_count = hist->buckets[i];
+
+        if ((cumulative + bucket_count) >= rank)
+        {
+            uint64_t width;
+            uint64_t value = latency_histogram_bucket_lower(i, &width);
+
+            value += ((width - 1u) * (rank - cumulative)) / bucket_count;
+
+            if (value < hist->min)
+            {
+                value = hist->min;
+            }
+            if (value > hist->max)
+            {
+                value = hist->max;
+            }
+            return value;
+        }
+
+        cumulative += bucket_count;
+    }
+
+    return hist->max;
+}
+
+/*******************************************************************************
+* Function Name: latency_histogram_log
+********************************************************************************
+* Summary:
+*   Print the latency percentiles (p50, p90, p99 and p99.9) of the histogram
+*   along with min, mean, max and jitter (p99 - p50).
+*
+* Parameters:
+*   hist: pointer to the histogram
+*   title: name of the measured quantity
+*
+* Return:
+*   void
+*******************************************************************************/
+void latency_histogram_log(const latency_histogram_t *hist, const char *title)
+{
+    uint64_t p50;
+    uint64_t p99;
+
+    if (hist->count == 0)
+    {
+        return;
+    }
+
+    p50 = latency_histogram_percentile(hist, 50.0f);
+    p99 = latency_histogram_percentile(hist, 99.0f);
+
+    printf("\r\n%s latency (%" PRIu32 " samples)\r\n", title, hist->count);
+    printf("  min=%" PRIu64 " mean=%" PRIu64 " max=%" PRIu64 "\r\n",
+           hist->min, hist->sum / hist->count, hist->max);
+    printf("  p50=%" PRIu64 " p90=%" PRIu64 " p99=%" PRIu64 " p99.9=%" PRIu64 "\r\n",
+           p50,
+           latency_histogram_percentile(hist, 90.0f),
+           p99,
+           latency_histogram_percentile(hist, 99.9f));
+    printf("  jitter (p99-p50)=%" PRIu64 "\r\n", p99 - p50);
+}
+
+/* [] END OF FILE */
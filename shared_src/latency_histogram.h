@@ -0,0 +1,83 @@
+/******************************************************************************
+* File Name:   latency_histogram.h
+*
+* Description: This file contains the function prototypes and constants used
+*              in latency_histogram.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+/* Number of bits used to split each power-of-two range into sub-buckets. Each
+ * sub-bucket covers at most 1/(2^LATENCY_HISTOGRAM_SUB_BITS) of its range. */
+#ifndef LATENCY_HISTOGRAM_SUB_BITS
+#define LATENCY_HISTOGRAM_SUB_BITS      (2u)
+#endif
+
+#define LATENCY_HISTOGRAM_SUB_BUCKETS   (1u << LATENCY_HISTOGRAM_SUB_BITS)
+
+/* Number of buckets needed to cover the full 32-bit range */
+#define LATENCY_HISTOGRAM_NUM_BUCKETS   (LATENCY_HISTOGRAM_SUB_BUCKETS * (33u - LATENCY_HISTOGRAM_SUB_BITS))
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t buckets[LATENCY_HISTOGRAM_NUM_BUCKETS];
+    uint32_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+} latency_histogram_t;
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+void latency_histogram_reset(latency_histogram_t *hist);
+void latency_histogram_record(latency_histogram_t *hist, uint64_t value);
+uint64_t latency_histogram_percentile(const latency_histogram_t *hist, float percentile);
+void latency_histogram_log(const latency_histogram_t *hist, const char *title);
+
+#endif /* LATENCY_HISTOGRAM_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,472 @@
+/******************************************************************************
+* File Name:   mem_usage.c
+*
+* Description: This file contains the implementation of the tensor arena
+*              and heap usage tracker. The arena is painted before the model
+*              uses it and scanned after the run. The heap is tracked by
+*              wrapping the C allocator.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "mem_usage.h"
+
+#if !defined(ML_PROFILER_HOST)
+#include "cybsp.h"
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(ML_HEAP_TRACKING)
+#include <malloc.h>
+#endif
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Painted tensor arena */
+static uint32_t *mem_usage_arena;
+static uint32_t  mem_usage_arena_size;
+
+/* True if the arena was registered by the inference engine. It takes
+ * precedence over the arena captured from the heap. */
+static bool mem_usage_arena_registered;
+
+#if defined(ML_HEAP_TRACKING)
+/* Heap statistics */
+static mem_usage_heap_t mem_usage_heap;
+
+/* True while the heap allocations are painted and captured as the arena */
+static bool mem_usage_capturing;
+#endif
+
+/*******************************************************************************
+* Function Name: mem_usage_paint
+********************************************************************************
+* Summary:
+*   Fill a memory region with the paint pattern.
+*
+* Parameters:
+*   region: pointer to the region (word aligned)
+*   size: size of the region in bytes
+*
+* Return:
+*   void
+*******************************************************************************/
+static void mem_usage_paint(uint32_t *region, uint32_t size)
+{
+    for (uint32_t i = 0; i < (size / sizeof(uint32_t)); i++)
+    {
+        region[i] = MEM_USAGE_PAINT_PATTERN;
+    }
+}
+
+/*******************************************************************************
+* Function Name: mem_usage_register_arena
+********************************************************************************
+* Summary:
+*   Paint the tensor arena and register it for the usage report. Call it
+*   before the inference engine writes to the arena.
+*
+* Parameters:
+*   arena: pointer to the tensor arena (word aligned)
+*   size: size of the tensor arena in bytes
+*
+* Return:
+*   void
+*******************************************************************************/
+void mem_usage_register_arena(void *arena, uint32_t size)
+{
+    mem_usage_paint((uint32_t *) arena, size);
+    mem_usage_arena = (uint32_t *) arena;
+    mem_usage_arena_size = size;
+    mem_usage_arena_registered = true;
+}
+
+/*******************************************************************************
+* Function Name: mem_usage_capture_begin
+********************************************************************************
+* Summary:
+*   Start capturing the tensor arena from the heap. Until
+*   mem_usage_capture_end() is called, the largest malloc() block is painted
+*   and taken as the arena. The calloc() and realloc() blocks are only
+*   counted: their contents must be kept. Wrap the model initialization with
+*   it for the inference engines that allocate their arena from the heap.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void mem_usage_capture_begin(void)
+{
+#if defined(ML_HEAP_TRACKING)
+    mem_usage_capturing = true;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: mem_usage_capture_end
+********************************************************************************
+* Summary:
+*   Stop capturing the tensor arena from the heap.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void mem_usage_capture_end(void)
+{
+#if defined(ML_HEAP_TRACKING)
+    mem_usage_capturing = false;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: mem_usage_get_arena
+********************************************************************************
+* Summary:
+*   Scan the painted tensor arena. The longest run of untouched words is
+*   taken as the free space: the engine fills the arena from the start with
+*   the planned tensors and scratch buffers, and from the end with the
+*   persistent buffers.
+*
+* Parameters:
+*   arena: returns the arena usage
+*
+* Return:
+*   bool: true if an arena was registered or captured
+*******************************************************************************/
+bool mem_usage_get_arena(mem_usage_arena_t *arena)
+{
+    uint32_t num_words = mem_usage_arena_size / sizeof(uint32_t);
+    uint32_t gap_start = num_words;
+    uint32_t gap_end = num_words;
+    uint32_t run_start = 0;
+
+    if (mem_usage_arena == NULL)
+    {
+        return false;
+    }
+
+#if !defined(ML_PROFILER_HOST) && defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    /* The NPU writes the arena behind the data cache */
+    SCB_CleanInvalidateDCache_by_Addr(mem_usage_arena, (int32_t) mem_usage_arena_size);
+#endif
+
+    for (uint32_t i = 0; i <= num_words; i++)
+    {
+        if ((i < num_words) && (mem_usage_arena[i] == MEM_USAGE_PAINT_PATTERN))
+        {
+            continue;
+        }
+        if ((i - run_start) > (gap_end - gap_start))
+        {
+            gap_start = run_start;
+            gap_end = i;
+        }
+        run_start = i + 1u;
+    }
+
+    arena->size = mem_usage_arena_size;
+    arena->scratch = gap_start * sizeof(uint32_t);
+    arena->persistent = mem_usage_arena_size - (gap_end * sizeof(uint32_t));
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: mem_usage_get_heap
+********************************************************************************
+* Summary:
+*   Get the heap statistics.
+*
+* Parameters:
+*   heap: returns the heap statistics
+*
+* Return:
+*   bool: true if the heap is tracked (ML_HEAP_TRACKING)
+*******************************************************************************/
+bool mem_usage_get_heap(mem_usage_heap_t *heap)
+{
+#if defined(ML_HEAP_TRACKING)
+    *heap = mem_usage_heap;
+    return true;
+#else
+    (void) heap;
+    return false;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: mem_usage_log
+********************************************************************************
+* Summary:
+*   Print the tensor arena and heap usage report.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void mem_usage_log(void)
+{
+    mem_usage_arena_t arena;
+    mem_usage_heap_t heap;
+
+    printf("\r\nMemory usage\r\n");
+
+    if (mem_usage_get_arena(&arena))
+    {
+        uint32_t used = arena.scratch + arena.persistent;
+
+        printf("  arena: size=%" PRIu32 " peak=%" PRIu32 " (scratch=%" PRIu32 " persistent=%" PRIu32 ") free=%" PRIu32 "\r\n",
+               arena.size, used, arena.scratch, arena.persistent, arena.size - used);
+    }
+    else
+    {
+        printf("  arena: not tracked\r\n");
+    }
+
+    if (mem_usage_get_heap(&heap))
+    {
+        printf("  heap: peak=%" PRIu32 " current=%" PRIu32 " allocations=%" PRIu32 "\r\n",
+               heap.peak, heap.current, heap.allocations);
+    }
+    else
+    {
+        printf("  heap: not tracked\r\n");
+    }
+}
+
+#if defined(ML_HEAP_TRACKING)
+/*******************************************************************************
+* Heap wrappers, linked with -Wl,--wrap=malloc,--wrap=free,--wrap=calloc,
+* --wrap=realloc. The block sizes are read with malloc_usable_size(), so blocks
+* allocated inside the C library can still be freed safely.
+*******************************************************************************/
+void *__real_malloc(size_t size);
+void  __real_free(void *ptr);
+void *__real_realloc(void *ptr, size_t size);
+void *__wrap_malloc(size_t size);
+void  __wrap_free(void *ptr);
+void *__wrap_calloc(size_t nmemb, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+
+/*******************************************************************************
+* Function Name: mem_usage_heap_add
+********************************************************************************
+* Summary:
+*   Account for a new heap block. While capturing, an uninitialized block is
+*   painted and taken as the arena if it is the largest one so far.
+*
+* Parameters:
+*   ptr: pointer to the block
+*   size: requested size of the block
+*   paint: true if the contents of the block are undefined (malloc)
+*
+* Return:
+*   void
+*******************************************************************************/
+static void mem_usage_heap_add(void *ptr, size_t size, bool paint)
+{
+    mem_usage_heap.current += (uint32_t) malloc_usable_size(ptr);
+    mem_usage_heap.allocations++;
+    if (mem_usage_heap.current > mem_usage_heap.peak)
+    {
+        mem_usage_heap.peak = mem_usage_heap.current;
+    }
+
+    if (paint && mem_usage_capturing && (!mem_usage_arena_registered) && (size > mem_usage_arena_size))
+    {
+        mem_usage_paint((uint32_t *) ptr, (uint32_t) size);
+        mem_usage_arena = (uint32_t *) ptr;
+        mem_usage_arena_size = (uint32_t) size;
+    }
+}
+
+/*******************************************************************************
+* Function Name: mem_usage_heap_remove
+********************************************************************************
+* Summary:
+*   Account for a heap block that is freed.
+*
+* Parameters:
+*   ptr: pointer to the block
+*   usable_size: usable size of the block
+*
+* Return:
+*   void
+*******************************************************************************/
+static void mem_usage_heap_remove(void *ptr, uint32_t usable_size)
+{
+    mem_usage_heap.current = (mem_usage_heap.current > usable_size) ?
+                             (mem_usage_heap.current - usable_size) : 0u;
+
+    if ((!mem_usage_arena_registered) && (ptr == (void *) mem_usage_arena))
+    {
+        mem_usage_arena = NULL;
+        mem_usage_arena_size = 0;
+    }
+}
+
+/*******************************************************************************
+* Function Name: __wrap_malloc
+********************************************************************************
+* Summary:
+*   Tracked malloc().
+*
+* Parameters:
+*   size: number of bytes to allocate
+*
+* Return:
+*   void *: pointer to the block, NULL if the allocation failed
+*******************************************************************************/
+void *__wrap_malloc(size_t size)
+{
+    void *ptr = __real_malloc(size);
+
+    if (ptr != NULL)
+    {
+        mem_usage_heap_add(ptr, size, true);
+    }
+
+    return ptr;
+}
+
+/*******************************************************************************
+* Function Name: __wrap_free
+********************************************************************************
+* Summary:
+*   Tracked free().
+*
+* Parameters:
+*   ptr: pointer to the block
+*
+* Return:
+*   void
+*******************************************************************************/
+void __wrap_free(void *ptr)
+{
+    if (ptr != NULL)
+    {
+        mem_usage_heap_remove(ptr, (uint32_t) malloc_usable_size(ptr));
+    }
+    __real_free(ptr);
+}
+
+/*******************************************************************************
+* Function Name: __wrap_calloc
+********************************************************************************
+* Summary:
+*   Tracked calloc().
+*
+* Parameters:
+*   nmemb: number of elements
+*   size: size of an element
+*
+* Return:
+*   void *: pointer to the zeroed block, NULL if the allocation failed
+*******************************************************************************/
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    void *ptr;
+
+    if ((size != 0u) && (nmemb > (SIZE_MAX / size)))
+    {
+        return NULL;
+    }
+
+    ptr = __real_malloc(nmemb * size);
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, nmemb * size);
+        mem_usage_heap_add(ptr, nmemb * size, false);
+    }
+
+    return ptr;
+}
+
+/*******************************************************************************
+* Function Name: __wrap_realloc
+********************************************************************************
+* Summary:
+*   Tracked realloc().
+*
+* Parameters:
+*   ptr: pointer to the block, or NULL
+*   size: new size of the block
+*
+* Return:
+*   void *: pointer to the resized block, NULL if the allocation failed
+*******************************************************************************/
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    uint32_t old_size = 0;
+    void *new_ptr;
+
+    if (ptr != NULL)
+    {
+        old_size = (uint32_t) malloc_usable_size(ptr);
+    }
+
+    new_ptr = __real_realloc(ptr, size);
+
+    /* On failure the old block is left untouched, unless size is zero */
+    if ((new_ptr != NULL) || (size == 0u))
+    {
+        if (ptr != NULL)
+        {
+            mem_usage_heap_remove(ptr, old_size);
+        }
+        if (new_ptr != NULL)
+        {
+            mem_usage_heap_add(new_ptr, size, false);
+        }
+    }
+
+    return new_ptr;
+}
+#endif /* ML_HEAP_TRACKING */
+
+/* [] END OF FILE */
@@ -0,0 +1,91 @@
+/******************************************************************************
+* File Name:   mem_usage.h
+*
+* Description: This file contains the public interface of the tensor arena
+*              and heap usage tracker.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef MEM_USAGE_H
+#define MEM_USAGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+/* Word written over the tensor arena before the model uses it */
+#define MEM_USAGE_PAINT_PATTERN (0xA5C3E1F7u)
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t size;       /* Size of the tensor arena */
+    uint32_t scratch;    /* Bytes used from the start (planned tensors, scratch) */
+    uint32_t persistent; /* Bytes used from the end (persistent buffers) */
+} mem_usage_arena_t;
+
+typedef struct
+{
+    uint32_t current;     /* Bytes currently allocated */
+    uint32_t peak;        /* Highest number of bytes allocated at once */
+    uint32_t allocations; /* Number of successful allocations */
+} mem_usage_heap_t;
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+void mem_usage_register_arena(void *arena, uint32_t size);
+void mem_usage_capture_begin(void);
+void mem_usage_capture_end(void);
+bool mem_usage_get_arena(mem_usage_arena_t *arena);
+bool mem_usage_get_heap(mem_usage_heap_t *heap);
+void mem_usage_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEM_USAGE_H */
+
+/* [] END OF FILE */
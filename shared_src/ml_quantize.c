@@ -0,0 +1,292 @@
+/******************************************************************************
+* File Name:   ml_quantize.c
+*
+* Description: This file contains the implementation of the quantization of
+*              raw uint8 or float inputs into the input tensor of the model.
+*              The loops use Helium on the CM55 and the DSP extension on the
+*              CM33, with a portable C fallback for the host build.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+
+#include "ml_quantize.h"
+
+#if defined(__ARM_FEATURE_MVE)
+#include <arm_mve.h>
+#elif defined(__ARM_FEATURE_DSP)
+#include "cmsis_compiler.h"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Range of the quantized inputs */
+#if defined(COMPONENT_ML_INT16x8)
+#define ML_QUANTIZE_MIN         (-32768)
+#define ML_QUANTIZE_MAX         (32767)
+#else
+#define ML_QUANTIZE_MIN         (-128)
+#define ML_QUANTIZE_MAX         (127)
+#endif
+
+#if !defined(COMPONENT_ML_FLOAT32)
+/*******************************************************************************
+* Function Name: ml_quantize_round
+********************************************************************************
+* Summary:
+*   Round a value in the int32 range to the nearest integer, halves away from
+*   zero, with a truncating conversion instead of a call to roundf().
+*
+* Parameters:
+*   value: value to round, in the int32 range
+*
+* Return:
+*   int32_t: the rounded value
+*******************************************************************************/
+static int32_t ml_quantize_round(float value)
+{
+    int32_t q = (int32_t) value;
+    float   frac = value - (float) q;
+
+    if (frac >= 0.5f)
+    {
+        q++;
+    }
+    else if (frac <= -0.5f)
+    {
+        q--;
+    }
+    return q;
+}
+#endif
+
+/*******************************************************************************
+* Function Name: ml_quantize_value
+********************************************************************************
+* Summary:
+*   Quantize one input: round(value / scale) + zero point, rounding halves
+*   away from zero and saturating to the input data type. The value is clamped
+*   before the conversion, so it is always in range, and NaN goes to the
+*   lowest value like in the Helium code. Float models take the value as is.
+*
+* Parameters:
+*   quant: quantization parameters
+*   value: raw input
+*
+* Return:
+*   MTB_ML_DATA_T: the quantized input
+*******************************************************************************/
+static MTB_ML_DATA_T ml_quantize_value(const ml_quantize_t *quant, float value)
+{
+#if defined(COMPONENT_ML_FLOAT32)
+    (void) quant;
+    return value;
+#else
+    float x = value * quant->inv_scale;
+
+    /* The bounds are integers, so clamping before rounding gives the same
+     * result as saturating after it. Written so that NaN goes to the min. */
+    if (!(x >= quant->min))
+    {
+        x = quant->min;
+    }
+    if (x > quant->max)
+    {
+        x = quant->max;
+    }
+    return (MTB_ML_DATA_T) (ml_quantize_round(x) + quant->zero_point);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: ml_quantize_init
+********************************************************************************
+* Summary:
+*   Set the quantization parameters of the input tensor, and build the table
+*   of the quantized value of every uint8 input.
+*
+* Parameters:
+*   quant: quantization parameters to initialize
+*   scale: scale of the input tensor, 1 if it is not positive
+*   zero_point: zero point of the input tensor
+*
+* Return:
+*   void
+*******************************************************************************/
+void ml_quantize_init(ml_quantize_t *quant, float scale, int32_t zero_point)
+{
+    quant->inv_scale = (scale > 0.0f) ? (1.0f / scale) : 1.0f;
+    quant->zero_point = zero_point;
+    quant->min = (float) ML_QUANTIZE_MIN - (float) zero_point;
+    quant->max = (float) ML_QUANTIZE_MAX - (float) zero_point;
+
+    for (uint32_t i = 0; i < 256u; i++)
+    {
+        quant->table[i] = ml_quantize_value(quant, (float) i);
+    }
+}
+
+/*******************************************************************************
+* Function Name: ml_quantize_u8
+********************************************************************************
+* Summary:
+*   Quantize uint8 inputs, such as image pixels, with the table built by
+*   ml_quantize_init(). Helium looks up 16 int8, 8 int16 or 4 float inputs per
+*   gather load. On the CM33, 4 inputs are loaded per word and the results are
+*   packed into word stores.
+*
+* Parameters:
+*   quant: quantization parameters
+*   src: raw inputs
+*   dst: quantized inputs
+*   count: number of inputs
+*
+* Return:
+*   void
+*******************************************************************************/
+void ml_quantize_u8(const ml_quantize_t *quant, const uint8_t *src, MTB_ML_DATA_T *dst,
+                    uint32_t count)
+{
+#if defined(__ARM_FEATURE_MVE)
+#if defined(COMPONENT_ML_FLOAT32)
+#if (__ARM_FEATURE_MVE & 2)
+    for (; count >= 4u; count -= 4u)
+    {
+        vst1q_f32(dst, vldrwq_gather_shifted_offset_f32(quant->table, vldrbq_u32(src)));
+        src += 4;
+        dst += 4;
+    }
+#endif
+#elif defined(COMPONENT_ML_INT16x8)
+    for (; count >= 8u; count -= 8u)
+    {
+        vst1q_s16(dst, vldrhq_gather_shifted_offset_s16(quant->table, vldrbq_u16(src)));
+        src += 8;
+        dst += 8;
+    }
+#else
+    for (; count >= 16u; count -= 16u)
+    {
+        vst1q_s8(dst, vldrbq_gather_offset_s8(quant->table, vld1q_u8(src)));
+        src += 16;
+        dst += 16;
+    }
+#endif
+#elif defined(__ARM_FEATURE_DSP) && !defined(COMPONENT_ML_FLOAT32)
+    for (; count >= 4u; count -= 4u)
+    {
+        uint32_t in = __UNALIGNED_UINT32_READ(src);
+#if defined(COMPONENT_ML_INT16x8)
+        __UNALIGNED_UINT32_WRITE(&dst[0], __PKHBT(quant->table[in & 0xFFu],
+                                                  quant->table[(in >> 8) & 0xFFu], 16));
+        __UNALIGNED_UINT32_WRITE(&dst[2], __PKHBT(quant->table[(in >> 16) & 0xFFu],
+                                                  quant->table[in >> 24], 16));
+#else
+        uint32_t out = (uint8_t) quant->table[in & 0xFFu] |
+                       ((uint32_t) (uint8_t) quant->table[(in >> 8) & 0xFFu] << 8) |
+                       ((uint32_t) (uint8_t) quant->table[(in >> 16) & 0xFFu] << 16) |
+                       ((uint32_t) (uint8_t) quant->table[in >> 24] << 24);
+
+        __UNALIGNED_UINT32_WRITE(dst, out);
+#endif
+        src += 4;
+        dst += 4;
+    }
+#endif
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        dst[i] = quant->table[src[i]];
+    }
+}
+
+/*******************************************************************************
+* Function Name: ml_quantize_f32
+********************************************************************************
+* Summary:
+*   Quantize float inputs. Every path clamps the scaled inputs to the range
+*   of the data type before the conversion, NaN included, so an input gives
+*   the same result wherever it is in the sample. Helium converts 4 inputs
+*   per vector, rounding halves away from zero like the scalar code. Float
+*   models copy the inputs.
+*
+* Parameters:
+*   quant: quantization parameters
+*   src: raw inputs
+*   dst: quantized inputs
+*   count: number of inputs
+*
+* Return:
+*   void
+*******************************************************************************/
+void ml_quantize_f32(const ml_quantize_t *quant, const float *src, MTB_ML_DATA_T *dst,
+                     uint32_t count)
+{
+#if defined(COMPONENT_ML_FLOAT32)
+    (void) quant;
+    if (dst != src)
+    {
+        memcpy(dst, src, count * sizeof(float));
+    }
+#else
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)
+    for (; count >= 4u; count -= 4u)
+    {
+        float32x4_t x = vmulq_n_f32(vld1q_f32(src), quant->inv_scale);
+        int32x4_t   q;
+
+        /* VMAXNM returns the number when the other operand is NaN */
+        x = vminnmq_f32(vmaxnmq_f32(x, vdupq_n_f32(quant->min)), vdupq_n_f32(quant->max));
+        q = vaddq_n_s32(vcvtaq_s32_f32(x), quant->zero_point);
+#if defined(COMPONENT_ML_INT16x8)
+        vstrhq_s32(dst, q);
+#else
+        vstrbq_s32(dst, q);
+#endif
+        src += 4;
+        dst += 4;
+    }
+#endif
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        dst[i] = ml_quantize_value(quant, src[i]);
+    }
+#endif
+}
+
+/* [] END OF FILE */
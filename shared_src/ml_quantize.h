@@ -0,0 +1,81 @@
+/******************************************************************************
+* File Name:   ml_quantize.h
+*
+* Description: This file contains the function prototypes and constants used
+*              in ml_quantize.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef ML_QUANTIZE_H
+#define ML_QUANTIZE_H
+
+#include <stdint.h>
+
+#include "mtb_ml.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+/* Quantization of raw inputs into the input tensor of the model */
+typedef struct
+{
+    float         inv_scale;  /* 1 / scale of the input tensor */
+    int32_t       zero_point; /* Zero point of the input tensor */
+    float         min;        /* Range of value / scale, without the zero point */
+    float         max;
+    MTB_ML_DATA_T table[256]; /* Quantized value of each uint8 input */
+} ml_quantize_t;
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+void ml_quantize_init(ml_quantize_t *quant, float scale, int32_t zero_point);
+void ml_quantize_u8(const ml_quantize_t *quant, const uint8_t *src, MTB_ML_DATA_T *dst,
+                    uint32_t count);
+void ml_quantize_f32(const ml_quantize_t *quant, const float *src, MTB_ML_DATA_T *dst,
+                     uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ML_QUANTIZE_H */
+
+/* [] END OF FILE */
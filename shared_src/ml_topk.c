@@ -0,0 +1,280 @@
+/******************************************************************************
+* File Name:   ml_topk.c
+*
+* Description: This file contains the implementation of the top-k selection
+*              of the model outputs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "ml_topk.h"
+
+#if defined(__ARM_FEATURE_MVE)
+#include <arm_mve.h>
+#elif defined(__ARM_FEATURE_DSP)
+#include "cmsis_compiler.h"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of values whose maximum is checked before they are ranked one by one */
+#define ML_TOPK_BLOCK_SIZE  (32)
+
+/*******************************************************************************
+* Function Name: ml_topk_block_max
+********************************************************************************
+* Summary:
+*   Find the largest of a block of values. Helium reduces 16 int8, 8 int16 or
+*   4 float values per vector, the DSP extension of the CM33 compares 4 int8
+*   or 2 int16 values per word. The host build relies on the compiler to
+*   vectorize the loop.
+*
+* Parameters:
+*   data: values, at least one
+*   size: number of values
+*
+* Return:
+*   MTB_ML_DATA_T: the largest value
+*******************************************************************************/
+static MTB_ML_DATA_T ml_topk_block_max(const MTB_ML_DATA_T *data, int size)
+{
+    MTB_ML_DATA_T max_value = data[0];
+    int i = 1;
+
+#if defined(__ARM_FEATURE_MVE) && defined(COMPONENT_ML_FLOAT32)
+#if (__ARM_FEATURE_MVE & 2)
+    if (size >= 4)
+    {
+        float32x4_t max_vec = vld1q_f32(data);
+
+        for (i = 4; (i + 4) <= size; i += 4)
+        {
+            max_vec = vmaxnmq_f32(max_vec, vld1q_f32(&data[i]));
+        }
+        max_value = vmaxnmvq_f32(max_value, max_vec);
+    }
+#endif
+#elif defined(__ARM_FEATURE_MVE) && defined(COMPONENT_ML_INT16x8)
+    if (size >= 8)
+    {
+        int16x8_t max_vec = vld1q_s16(data);
+
+        for (i = 8; (i + 8) <= size; i += 8)
+        {
+            max_vec = vmaxq_s16(max_vec, vld1q_s16(&data[i]));
+        }
+        max_value = vmaxvq_s16(max_value, max_vec);
+    }
+#elif defined(__ARM_FEATURE_MVE)
+    if (size >= 16)
+    {
+        int8x16_t max_vec = vld1q_s8(data);
+
+        for (i = 16; (i + 16) <= size; i += 16)
+        {
+            max_vec = vmaxq_s8(max_vec, vld1q_s8(&data[i]));
+        }
+        max_value = vmaxvq_s8(max_value, max_vec);
+    }
+#elif defined(__ARM_FEATURE_DSP) && defined(COMPONENT_ML_INT16x8)
+    if (size >= 2)
+    {
+        uint32_t max_word = __UNALIGNED_UINT32_READ(data);
+
+        /* __SSUB16 sets the GE flags of the halfwords greater or equal,
+         * __SEL picks them */
+        for (i = 2; (i + 2) <= size; i += 2)
+        {
+            uint32_t word = __UNALIGNED_UINT32_READ(&data[i]);
+
+            (void) __SSUB16(word, max_word);
+            max_word = __SEL(word, max_word);
+        }
+        max_value = (int16_t) max_word;
+        if ((int16_t) (max_word >> 16) > max_value)
+        {
+            max_value = (int16_t) (max_word >> 16);
+        }
+    }
+#elif defined(__ARM_FEATURE_DSP) && !defined(COMPONENT_ML_FLOAT32)
+    if (size >= 4)
+    {
+        uint32_t max_word = __UNALIGNED_UINT32_READ(data);
+
+        /* Same with __SSUB8 for the 4 bytes of a word */
+        for (i = 4; (i + 4) <= size; i += 4)
+        {
+            uint32_t word = __UNALIGNED_UINT32_READ(&data[i]);
+
+            (void) __SSUB8(word, max_word);
+            max_word = __SEL(word, max_word);
+        }
+        max_value = (int8_t) max_word;
+        for (uint32_t shift = 8u; shift < 32u; shift += 8u)
+        {
+            if ((int8_t) (max_word >> shift) > max_value)
+            {
+                max_value = (int8_t) (max_word >> shift);
+            }
+        }
+    }
+#endif
+
+    for (; i < size; i++)
+    {
+        if (data[i] > max_value)
+        {
+            max_value = data[i];
+        }
+    }
+
+    return max_value;
+}
+
+/*******************************************************************************
+* Function Name: ml_topk
+********************************************************************************
+* Summary:
+*   Find the indices of the k largest values, largest first. Equal values are
+*   ranked by index, so the first index is the one mtb_ml_utils_find_max()
+*   returns. The top-1 index is found from the vector maximum of all the
+*   values. Otherwise, once k values are ranked, the blocks whose maximum
+*   does not beat the last of them are skipped.
+*
+* Parameters:
+*   data: values to rank
+*   size: number of values
+*   k: number of indices to return, up to ML_TOPK_MAX_K and size
+*   indices: returns the indices
+*
+* Return:
+*   void
+*******************************************************************************/
+void ml_topk(const MTB_ML_DATA_T *data, int size, uint32_t k, uint16_t *indices)
+{
+    uint32_t found = 0;
+
+    if ((k == 0u) || (size <= 0))
+    {
+        return;
+    }
+
+    if (k == 1u)
+    {
+        MTB_ML_DATA_T max_value = ml_topk_block_max(data, size);
+
+        /* First index of the maximum, 0 if none is equal to it (NaN) */
+        indices[0] = 0u;
+        for (int i = 0; i < size; i++)
+        {
+            if (data[i] == max_value)
+            {
+                indices[0] = (uint16_t) i;
+                break;
+            }
+        }
+        return;
+    }
+
+    for (int start = 0; start < size; start += ML_TOPK_BLOCK_SIZE)
+    {
+        int end = ((size - start) > ML_TOPK_BLOCK_SIZE) ? (start + ML_TOPK_BLOCK_SIZE) : size;
+
+        if ((found == k) &&
+            !(ml_topk_block_max(&data[start], end - start) > data[indices[k - 1u]]))
+        {
+            continue;
+        }
+
+        for (int i = start; i < end; i++)
+        {
+            uint32_t pos = found;
+
+            /* Insert the value in the sorted list if it beats its last entry */
+            while ((pos > 0u) && (data[i] > data[indices[pos - 1u]]))
+            {
+                if (pos < k)
+                {
+                    indices[pos] = indices[pos - 1u];
+                }
+                pos--;
+            }
+            if (pos < k)
+            {
+                indices[pos] = (uint16_t) i;
+                if (found < k)
+                {
+                    found++;
+                }
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: ml_topk_score
+********************************************************************************
+* Summary:
+*   Quantize an output value to 8 bits for a compact reply. Integer outputs
+*   keep their 8 most significant bits, offset to be unsigned. Float outputs
+*   are expected to be probabilities and are scaled from [0, 1] to [0, 255].
+*
+* Parameters:
+*   value: model output
+*
+* Return:
+*   uint8_t: the quantized score
+*******************************************************************************/
+uint8_t ml_topk_score(MTB_ML_DATA_T value)
+{
+#if defined(COMPONENT_ML_FLOAT32)
+    if (value <= 0.0f)
+    {
+        return 0u;
+    }
+    if (value >= 1.0f)
+    {
+        return 255u;
+    }
+    return (uint8_t) ((value * 255.0f) + 0.5f);
+#elif defined(COMPONENT_ML_INT16x8)
+    return (uint8_t) ((((int32_t) value) >> 8) + 128);
+#else
+    return (uint8_t) (((int32_t) value) + 128);
+#endif
+}
+
+/* [] END OF FILE */
@@ -41,24 +41,132 @@
 *******************************************************************************/
 #include "ml_validation.h"
 
+#if !defined(ML_PROFILER_HOST)
+#include "cybsp.h"
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <inttypes.h>
+#include <string.h>
+
+#include "elapsed_timer.h"
+#include "latency_histogram.h"
+#include "mem_usage.h"
+#include "ml_topk.h"
+#include "stack_usage.h"
+#include "trace_buffer.h"
+
+#if ML_PROFILE_OPS
+#include "op_profiler.h"
+#endif
+
+#if defined(ML_STREAM_PIPELINE)
+#include "ml_quantize.h"
+#include "stream_codec.h"
+#include "stream_port.h"
+#include "stream_proto.h"
+#endif
+
+#if ML_INPUT_IN_PLACE && !defined(ML_MODEL_INVOKE)
+#include "tensorflow/lite/c/common.h"
+#endif
 
 #ifndef USE_STREAM_DATA
 /* Include regression files */
+#if defined(ML_X_DATA_COMPRESSED)
+#include "ml_x_compressed.h"
+#include ML_X_COMPRESSED_FILE(MODEL_NAME)
+#else
 #include MTB_ML_INCLUDE_MODEL_X_DATA_FILE(MODEL_NAME)
+#endif
+#if defined(ML_Y_DATA_LABELS)
+#include "ml_y_labels.h"
+#include ML_Y_LABELS_FILE(MODEL_NAME)
+#else
 #include MTB_ML_INCLUDE_MODEL_Y_DATA_FILE(MODEL_NAME)
 #endif
+#endif
 
 /*******************************************************************************
 * Constants
 *******************************************************************************/
 #define SUCCESS_RATE       (98.0f)
 
+/* Classes ranked for the top-5 accuracy of the local regression */
+#define TOP_N_ACCURACY     (5u)
+
+/* Largest difference between the output of the model for the reference class
+ * and the reference score of the label-only y data */
+#ifndef ML_VALIDATION_SCORE_TOLERANCE
+#if defined(COMPONENT_ML_FLOAT32)
+#define ML_VALIDATION_SCORE_TOLERANCE   (0.02f)
+#elif defined(COMPONENT_ML_INT16x8)
+#define ML_VALIDATION_SCORE_TOLERANCE   (256.0f)
+#else
+#define ML_VALIDATION_SCORE_TOLERANCE   (2.0f)
+#endif
+#endif
+
 /* Timeout value for streaming */
 #define DEFAULT_TIMEOUT_MS (5000u)
 
+/* Number of inferences run on the first sample before profiling starts.
+ * They pay for cold caches and lazy kernel setup, and are excluded from the
+ * statistics. */
+#ifndef ML_VALIDATION_WARMUP_COUNT
+#define ML_VALIDATION_WARMUP_COUNT  (1u)
+#endif
+
+/* Size of the buffer swept to evict the caches on a host build */
+#define HOST_EVICT_BUFFER_SIZE      (32u * 1024u * 1024u)
+
+/* Data type of the samples, reported to the host by the pipelined stream */
+#if defined(COMPONENT_ML_FLOAT32)
+#define PIPELINE_DATA_TYPE          STREAM_PROTO_DATA_FLOAT
+#elif defined(COMPONENT_ML_INT16x8)
+#define PIPELINE_DATA_TYPE          STREAM_PROTO_DATA_INT16
+#else
+#define PIPELINE_DATA_TYPE          STREAM_PROTO_DATA_INT8
+#endif
+
+/* Model memory saved by an RNN state checkpoint in the stateful pipelined
+ * stream: the variable tensors of the model, and nothing else. mtb-ml does
+ * not expose them, so the build must give their location, for example with
+ * DEFINES+='ML_RNN_STATE_BUFFER(model)=...' 'ML_RNN_STATE_SIZE(model)=...'.
+ * The host stand-in defines both in its mtb_ml.h. */
+#if defined(RNN_STREAMING) && defined(ML_STREAM_PIPELINE)
+#if !defined(ML_RNN_STATE_BUFFER) && !defined(ML_PROFILER_HOST)
+#error "Define ML_RNN_STATE_BUFFER(model) and ML_RNN_STATE_SIZE(model) to the variable tensors of the RNN model"
+#endif
+#endif
+
+/* Run the streamed samples from the input tensor of the model, where they are
+ * received, decoded or quantized, without the input copy of
+ * mtb_ml_model_run(). It needs a direct invoke of the inference engine on its
+ * input tensor: the invoke function of the interpreter-less model
+ * (NN_INPUT_IN_PLACE=yes with tflm_less), or ML_MODEL_INVOKE(model) and
+ * ML_MODEL_INPUT_PTR(model) given by the build, like the host stand-in does
+ * in its mtb_ml.h. */
+#ifndef ML_INPUT_IN_PLACE
+#define ML_INPUT_IN_PLACE           (0)
+#endif
+
+#if ML_INPUT_IN_PLACE && !defined(ML_MODEL_INVOKE)
+#if !defined(COMPONENT_ML_TFLM_LESS)
+#error "ML_INPUT_IN_PLACE needs the tflm_less inference engine, or ML_MODEL_INVOKE(model) and ML_MODEL_INPUT_PTR(model)"
+#endif
+#define ML_MODEL_FN_(name, fn)      name##fn
+#define ML_MODEL_FN(name, fn)       ML_MODEL_FN_(name, fn)
+#define ML_MODEL_INVOKE(model)      ((kTfLiteOk == ML_MODEL_FN(MODEL_NAME, _invoke)()) ? \
+                                     MTB_ML_RESULT_SUCCESS : MTB_ML_RESULT_INFERENCE_ERROR)
+#define ML_MODEL_INPUT_PTR(model)   ((MTB_ML_DATA_T *) ML_MODEL_FN(MODEL_NAME, _input_ptr)(0))
+
+/* Invoke and input tensor functions of the generated interpreter-less model */
+extern TfLiteStatus ML_MODEL_FN(MODEL_NAME, _invoke)(void);
+extern void *ML_MODEL_FN(MODEL_NAME, _input_ptr)(int index);
+#endif
+
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
@@ -71,348 +179,1759 @@ static MTB_ML_DATA_T *result_buffer;
 /* Model Output Size */
 static int model_output_size;
 
+/* Profiling configuration */
+static mtb_ml_profile_config_t profile_config;
+
+/* Latency distribution of the steady-state inferences */
+static latency_histogram_t steady_latency;
+
+#if defined(ML_VALIDATION_COLD_MODE)
+/* Latency distribution of the inferences run with flushed caches */
+static latency_histogram_t cold_latency;
+#endif
+
+/* Number of inferences run since initialization */
+static uint32_t inference_count;
+
+/* Latency of the very first inference after initialization */
+static uint64_t first_inference_cycles;
+static bool     first_inference_done;
+
+/* Time spent per streamed sample receiving, computing and transmitting */
+static latency_histogram_t stream_rx_latency;
+static latency_histogram_t stream_compute_latency;
+static latency_histogram_t stream_tx_latency;
+
+/* Wall time of the streamed samples, from the first receive to the last
+ * transmit */
+static uint64_t stream_wall_cycles;
+
+/* RX buffer of the stream, kept across sessions. It is only used for the
+ * samples that are not received in the input tensor. */
+static MTB_ML_DATA_T *stream_rx_buf;
+static uint32_t       stream_rx_buf_size;
+
+#if ML_INPUT_IN_PLACE
+/* True if the direct invoke runs the input tensor of model_obj, so the
+ * samples can be written there */
+static bool model_input_in_place;
+
+/* Number of samples run from the input tensor, without a copy */
+static uint32_t stream_in_place_count;
+#endif
+
+#if defined(ML_STREAM_PIPELINE)
+/* Sample buffers of the pipelined stream, kept across sessions */
+static uint8_t *pipeline_pool;
+static uint32_t pipeline_pool_size;
+
+/* Replies of the last window of batches, at the end of the sample buffers.
+ * They are kept until the host can no longer ask for them again. */
+static uint8_t *pipeline_results;
+
+/* INFO and DONE payloads, kept to be sent again */
+static stream_info_t pipeline_info;
+static stream_done_t pipeline_done;
+
+/* Number of classes per reply, 0 if the full outputs are sent */
+static uint32_t pipeline_top_k;
+
+/* Decoded sample if the payloads are compressed, NULL otherwise. It is only
+ * used for the samples that are not decoded in the input tensor. */
+static MTB_ML_DATA_T *pipeline_decoded;
+
+/* Format of the samples (STREAM_PROTO_INPUT_xxx), and the quantization of the
+ * raw samples */
+static uint32_t      pipeline_input_format;
+static bool          pipeline_quantize;
+static ml_quantize_t pipeline_quant;
+
+/* Quantized sample if the samples are raw, NULL otherwise. It is only used
+ * for the samples that are not quantized in the input tensor. */
+static MTB_ML_DATA_T *pipeline_quantized;
+
+/* Time spent decoding the compressed samples, and the bytes decoded */
+static latency_histogram_t stream_decode_latency;
+static uint64_t stream_decode_in_bytes;
+static uint64_t stream_decode_out_bytes;
+
+/* Time spent quantizing the raw samples, and the inputs quantized */
+static latency_histogram_t stream_quantize_latency;
+static uint64_t stream_quantize_inputs;
+
+/* True once the stream port is receiving */
+static bool pipeline_port_ready;
+#endif
+
+#if defined(RNN_STREAMING)
+/* True if the RNN state is kept from one sample to the next, so a sample
+ * only holds the new time steps. False if every sample is a full sequence,
+ * run from a reset state. */
+static bool rnn_stateful;
+#endif
+
+#if defined(RNN_STREAMING) && defined(ML_STREAM_PIPELINE)
+/* Checkpoint of the RNN state, kept across sessions */
+static uint8_t *rnn_checkpoint;
+static uint32_t rnn_checkpoint_size;
+#endif
+
+#ifndef USE_STREAM_DATA
+/* Class of the reference output of each regression sample, computed on the
+ * first run of the regression and kept for the next ones, or read from the
+ * label-only y data */
+static const void *reference_labels;
+
+/* Size in bytes of each entry of reference_labels, 1 or 2 */
+static uint32_t reference_label_size;
+
+#if defined(ML_Y_DATA_LABELS)
+/* Reference output of the model for the class of each sample, NULL if the
+ * label-only y data has no scores */
+static const MTB_ML_DATA_T *reference_scores;
+#endif
+
+#if defined(ML_X_DATA_COMPRESSED)
+/* Reader of the compressed x data, and the buffer it decompresses a sample
+ * into */
+static ml_x_compressed_t x_reader;
+static MTB_ML_DATA_T    *x_scratch;
+
+/* Decompression time and sizes of the x data samples */
+static latency_histogram_t x_decompress_latency;
+static uint64_t x_decompress_in_bytes;
+static uint64_t x_decompress_out_bytes;
+#endif
+#endif
+
+#if defined(ML_VALIDATION_COLD_MODE) && defined(ML_PROFILER_HOST)
+/* Buffer swept to evict the host caches */
+static uint8_t host_evict_buffer[HOST_EVICT_BUFFER_SIZE];
+#endif
+
 /*******************************************************************************
-* Function Name: ml_validation_init
+* Function Name: ml_validation_profile_reset
 ********************************************************************************
 * Summary:
-*   Initialize the Neural Network based on the given model and setup to start
-*   regression of the model and profiling configuration.
+*   Clear the profiling statistics collected by the validation tasks.
 *
 * Parameters:
-*   profile_cfg: profiling configuration
-*   model_bin: pointer to the model data
+*   void
 *
 * Return:
-*   cy_rslt_t: the status of the initialization.
+*   void
 *******************************************************************************/
-cy_rslt_t ml_validation_init(mtb_ml_profile_config_t profile_cfg,
-                             mtb_ml_model_bin_t *model_bin)
+static void ml_validation_profile_reset(void)
 {
-    cy_rslt_t result;
+    latency_histogram_reset(&steady_latency);
+    latency_histogram_reset(&stream_rx_latency);
+    latency_histogram_reset(&stream_compute_latency);
+    latency_histogram_reset(&stream_tx_latency);
+    stream_wall_cycles = 0;
+#if ML_INPUT_IN_PLACE
+    stream_in_place_count = 0;
+#endif
+#if defined(ML_STREAM_PIPELINE)
+    latency_histogram_reset(&stream_decode_latency);
+    stream_decode_in_bytes = 0;
+    stream_decode_out_bytes = 0;
+    latency_histogram_reset(&stream_quantize_latency);
+    stream_quantize_inputs = 0;
+#endif
+#if defined(ML_X_DATA_COMPRESSED) && !defined(USE_STREAM_DATA)
+    latency_histogram_reset(&x_decompress_latency);
+    x_decompress_in_bytes = 0;
+    x_decompress_out_bytes = 0;
+#endif
+#if defined(ML_VALIDATION_COLD_MODE)
+    latency_histogram_reset(&cold_latency);
+#endif
+#if ML_PROFILE_OPS
+    op_profiler_reset();
+#endif
+#if defined(ML_TRACE)
+    trace_buffer_reset();
+#endif
+}
 
-    /* Initialize the neural network */
-    result = mtb_ml_model_init(model_bin,
-                               NULL,
-                               &model_obj);
-    if (CY_RSLT_SUCCESS != result)
+/*******************************************************************************
+* Function Name: ml_validation_stream_log
+********************************************************************************
+* Summary:
+*   Print the breakdown of the streamed samples into receive, compute and
+*   transmit time, and the compute utilization (compute / wall time).
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+static void ml_validation_stream_log(void)
+{
+    float utilization = 0.0f;
+
+    if (stream_compute_latency.count == 0)
     {
-        printf("MTB ML initialization failure: %lu\r\n", (unsigned long) result);
-        return result;
+        return;
     }
 
-    mtb_ml_model_profile_config(model_obj, profile_cfg);
+    latency_histogram_log(&stream_rx_latency, "Stream receive");
+    latency_histogram_log(&stream_compute_latency, "Stream compute");
+    latency_histogram_log(&stream_tx_latency, "Stream transmit");
 
-    mtb_ml_model_get_output(model_obj, &result_buffer, &model_output_size);
+    if (stream_wall_cycles != 0)
+    {
+        utilization = ((float) stream_compute_latency.sum) * 100.0f / ((float) stream_wall_cycles);
+    }
 
-    /* Print information about the model */
-    mtb_ml_utils_print_model_info(model_obj);
+    printf("\r\nStream breakdown (%" PRIu32 " samples)\r\n", stream_compute_latency.count);
+    printf("  total: receive=%" PRIu64 " compute=%" PRIu64 " transmit=%" PRIu64 " wall=%" PRIu64 " cycles\r\n",
+           stream_rx_latency.sum, stream_compute_latency.sum, stream_tx_latency.sum, stream_wall_cycles);
+    printf("  compute utilization (compute / wall): %3.2f%%\r\n", (double) utilization);
+#if ML_INPUT_IN_PLACE
+    printf("  input tensor: %" PRIu32 " of %" PRIu32 " samples written in place\r\n",
+           stream_in_place_count, stream_compute_latency.count);
+#endif
+
+#if defined(ML_STREAM_PIPELINE)
+    {
+        stream_proto_stats_t   stats;
+        stream_port_tx_stats_t tx_stats;
+        uint32_t               overflows;
+
+        stream_proto_get_stats(&stats);
+        stream_port_get_errors(&overflows);
+        stream_port_get_tx_stats(&tx_stats);
+        printf("  link: frames=%" PRIu32 " bad headers=%" PRIu32 " crc errors=%" PRIu32 " duplicates=%" PRIu32
+               " uart overflows=%" PRIu32 "\r\n",
+               stats.frames, stats.bad_headers, stats.crc_errors, stats.duplicates, overflows);
+        printf("  retransmissions: naks sent=%" PRIu32 " frames resent=%" PRIu32 "\r\n",
+               stats.naks_sent, stats.resends);
+        printf("  tx queue: size=%" PRIu32 " high-water=%" PRIu32 " bytes, stalls=%" PRIu32 "\r\n",
+               tx_stats.size, tx_stats.high_water, tx_stats.stalls);
+    }
+
+    if ((stream_decode_latency.count != 0) && (stream_decode_in_bytes != 0))
+    {
+        latency_histogram_log(&stream_decode_latency, "Stream decode");
+        printf("  total: in=%" PRIu64 " out=%" PRIu64 " bytes (ratio %.2f), %.2f cycles per decoded byte\r\n",
+               stream_decode_in_bytes, stream_decode_out_bytes,
+               (double) stream_decode_out_bytes / (double) stream_decode_in_bytes,
+               (double) stream_decode_latency.sum / (double) stream_decode_out_bytes);
+    }
+
+    if ((stream_quantize_latency.count != 0) && (stream_quantize_inputs != 0))
+    {
+        latency_histogram_log(&stream_quantize_latency, "Stream quantize");
+        printf("  total: %" PRIu64 " %s inputs, %.2f cycles per input\r\n",
+               stream_quantize_inputs, (pipeline_input_format == STREAM_PROTO_INPUT_UINT8) ? "uint8" : "float",
+               (double) stream_quantize_latency.sum / (double) stream_quantize_inputs);
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: ml_validation_profile_log
+********************************************************************************
+* Summary:
+*   Print the model profiling log, followed by the statistics collected by the
+*   validation tasks if profiling is enabled.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   cy_rslt_t: the status of the model profiling log.
+*******************************************************************************/
+static cy_rslt_t ml_validation_profile_log(void)
+{
+    cy_rslt_t result = mtb_ml_model_profile_log(model_obj);
+
+    if ((MTB_ML_RESULT_SUCCESS == result) && (MTB_ML_PROFILE_DISABLE != profile_config))
+    {
+        uint64_t overhead_min;
+        uint64_t overhead_median;
+
+        elapsed_timer_get_overhead(&overhead_min, &overhead_median);
+        printf("\r\nCycle counter: %s (timer overhead min=%" PRIu64 " median=%" PRIu64 ")\r\n",
+               elapsed_timer_get_source_name(), overhead_min, overhead_median);
+        if (first_inference_done)
+        {
+            printf("\r\nFirst inference latency: %" PRIu64 " cycles\r\n", first_inference_cycles);
+        }
+#if defined(ML_VALIDATION_COLD_MODE)
+        latency_histogram_log(&cold_latency, "Cold inference");
+#endif
+        latency_histogram_log(&steady_latency, "Steady-state inference");
+#if defined(ML_X_DATA_COMPRESSED) && !defined(USE_STREAM_DATA)
+        if ((x_decompress_latency.count != 0) && (x_decompress_in_bytes != 0))
+        {
+            latency_histogram_log(&x_decompress_latency, "X data decompress");
+            printf("  total: in=%" PRIu64 " out=%" PRIu64 " bytes (ratio %.2f), %.2f cycles per decoded byte\r\n",
+                   x_decompress_in_bytes, x_decompress_out_bytes,
+                   (double) x_decompress_out_bytes / (double) x_decompress_in_bytes,
+                   (double) x_decompress_latency.sum / (double) x_decompress_out_bytes);
+        }
+#endif
+        ml_validation_stream_log();
+        mem_usage_log();
+        stack_usage_log();
+#if ML_PROFILE_OPS
+        op_profiler_log();
+#endif
+#if defined(ML_TRACE)
+        trace_buffer_dump();
+#endif
+    }
+
+    return result;
+}
+
+#if defined(ML_VALIDATION_COLD_MODE)
+/*******************************************************************************
+* Function Name: ml_validation_flush_caches
+********************************************************************************
+* Summary:
+*   Clean and invalidate the CPU caches, so the next inference starts cold.
+*   On a host build, the caches are evicted by sweeping a large buffer.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+static void ml_validation_flush_caches(void)
+{
+#if defined(ML_PROFILER_HOST)
+    for (uint32_t i = 0; i < HOST_EVICT_BUFFER_SIZE; i += 64u)
+    {
+        host_evict_buffer[i]++;
+    }
+#else
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_CleanInvalidateDCache();
+#endif
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1U)
+    SCB_InvalidateICache();
+#endif
+#endif /* ML_PROFILER_HOST */
+}
+#endif /* ML_VALIDATION_COLD_MODE */
+
+/*******************************************************************************
+* Function Name: ml_validation_input_buffer
+********************************************************************************
+* Summary:
+*   Get the buffer a streamed sample is written into: the input tensor of the
+*   model, so it is run without the input copy of mtb_ml_model_run(), or the
+*   given buffer. The inference engine may reuse the input tensor memory for
+*   other tensors, so a sample run more than once (warm-up, cold mode) or one
+*   time step at a time (RNN) is kept in the given buffer.
+*
+* Parameters:
+*   buffer: buffer of the sample if it is not written in the input tensor
+*   first_sample: true if this is the first sample of the session
+*
+* Return:
+*   MTB_ML_DATA_T *: the buffer to write the sample into
+*******************************************************************************/
+static MTB_ML_DATA_T *ml_validation_input_buffer(MTB_ML_DATA_T *buffer, bool first_sample)
+{
+#if ML_INPUT_IN_PLACE && !defined(RNN_STREAMING) && !defined(ML_VALIDATION_COLD_MODE)
+    if (model_input_in_place && (!first_sample || (ML_VALIDATION_WARMUP_COUNT == 0u)))
+    {
+        return model_obj->input;
+    }
+#else
+    (void) first_sample;
+#endif
+    return buffer;
+}
+
+/*******************************************************************************
+* Function Name: ml_validation_model_run
+********************************************************************************
+* Summary:
+*   Run the model on one input. An input already written in the input tensor
+*   is run by the direct invoke of the inference engine, since
+*   mtb_ml_model_run() would copy it onto itself.
+*
+* Parameters:
+*   input: pointer to the input
+*
+* Return:
+*   cy_rslt_t: the status of the inference.
+*******************************************************************************/
+static cy_rslt_t ml_validation_model_run(MTB_ML_DATA_T *input)
+{
+#if ML_INPUT_IN_PLACE
+    if (input == model_obj->input)
+    {
+        stream_in_place_count++;
+        return ML_MODEL_INVOKE(model_obj);
+    }
+#endif
+    return mtb_ml_model_run(model_obj, input);
+}
+
+#if defined(RNN_STREAMING)
+/*******************************************************************************
+* Function Name: ml_validation_run_timesteps
+********************************************************************************
+* Summary:
+*   Run the model on consecutive time steps of a sequence. The time steps are
+*   stored one after the other, model input size elements apart, so each one
+*   is passed to the model where it is, without a copy.
+*
+* Parameters:
+*   sequence: pointer to the first time step to run
+*   count: number of time steps to run
+*
+* Return:
+*   cy_rslt_t: the status of the inferences.
+*******************************************************************************/
+static cy_rslt_t ml_validation_run_timesteps(MTB_ML_DATA_T *sequence, int count)
+{
+    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+
+    for (int i = 0; i < count; i++)
+    {
+        result = ml_validation_model_run(&sequence[i * model_obj->input_size]);
+
+        /* Check if the inferencing return any error */
+        if (MTB_ML_RESULT_SUCCESS != result)
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+#endif /* RNN_STREAMING */
+
+#if defined(RNN_STREAMING) && defined(ML_STREAM_PIPELINE)
+/*******************************************************************************
+* Function Name: ml_validation_rnn_alloc_checkpoint
+********************************************************************************
+* Summary:
+*   Allocate the RNN state checkpoint. It is kept across sessions, and only
+*   reallocated if the state of the model grew.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   cy_rslt_t: the status of the allocation.
+*******************************************************************************/
+static cy_rslt_t ml_validation_rnn_alloc_checkpoint(void)
+{
+    uint32_t size = ML_RNN_STATE_SIZE(model_obj);
+
+    if (rnn_checkpoint_size < size)
+    {
+        free(rnn_checkpoint);
+        rnn_checkpoint = (uint8_t *) malloc(size);
+        rnn_checkpoint_size = (rnn_checkpoint != NULL) ? size : 0u;
+    }
+
+    return (rnn_checkpoint != NULL) ? MTB_ML_RESULT_SUCCESS : MTB_ML_RESULT_ALLOC_ERR;
+}
+
+/*******************************************************************************
+* Function Name: ml_validation_rnn_checkpoint
+********************************************************************************
+* Summary:
+*   Save the RNN state, to be restored by ml_validation_rnn_restore().
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+static void ml_validation_rnn_checkpoint(void)
+{
+    memcpy(rnn_checkpoint, ML_RNN_STATE_BUFFER(model_obj), ML_RNN_STATE_SIZE(model_obj));
+}
+
+/*******************************************************************************
+* Function Name: ml_validation_rnn_restore
+********************************************************************************
+* Summary:
+*   Restore the RNN state saved by the last ml_validation_rnn_checkpoint().
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+static void ml_validation_rnn_restore(void)
+{
+    memcpy(ML_RNN_STATE_BUFFER(model_obj), rnn_checkpoint, ML_RNN_STATE_SIZE(model_obj));
+}
+#endif /* RNN_STREAMING && ML_STREAM_PIPELINE */
+
+/*******************************************************************************
+* Function Name: ml_validation_run_sample
+********************************************************************************
+* Summary:
+*   Run the inference of one sample and measure its latency. For RNN models,
+*   the model is reset and all the time steps of the sample are run. In
+*   stateful mode, the time steps of the sample continue the previous ones.
+*
+* Parameters:
+*   input: pointer to the sample
+*   cycles: returns the latency of the inference
+*
+* Return:
+*   cy_rslt_t: the status of the inference.
+*******************************************************************************/
+static cy_rslt_t ml_validation_run_sample(MTB_ML_DATA_T *input, uint64_t *cycles)
+{
+    cy_rslt_t result;
+    uint64_t  start_tick;
+    uint64_t  end_tick;
+
+#if defined(RNN_STREAMING)
+    if (!rnn_stateful)
+    {
+        result = mtb_ml_model_rnn_reset_all_parameters(model_obj);
+        if (MTB_ML_RESULT_SUCCESS != result)
+        {
+            printf("ERROR: failed to reset model parameters\r\n");
+            return MTB_ML_RESULT_INFERENCE_ERROR;
+        }
+    }
+
+    TRACE_EVENT(TRACE_EVENT_INFERENCE_START, inference_count);
+    elapsed_timer_get_tick(&start_tick);
+
+    /* Input data is 2D array squashed to 1D array by Coretools */
+    result = ml_validation_run_timesteps(input, model_obj->recurrent_ts_size);
+    if (MTB_ML_RESULT_SUCCESS != result)
+    {
+        return result;
+    }
+#else
+    TRACE_EVENT(TRACE_EVENT_INFERENCE_START, inference_count);
+    elapsed_timer_get_tick(&start_tick);
+
+    result = ml_validation_model_run(input);
+
+    /* Check if the inferencing return any error */
+    if (MTB_ML_RESULT_SUCCESS != result)
+    {
+        return result;
+    }
+#endif /* RNN_STREAMING */
+
+    elapsed_timer_get_tick(&end_tick);
+    TRACE_EVENT(TRACE_EVENT_INFERENCE_END, inference_count);
+    inference_count++;
+
+    *cycles = end_tick - start_tick;
+
+    if (!first_inference_done)
+    {
+        first_inference_cycles = *cycles;
+        first_inference_done = true;
+    }
+
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: ml_validation_run_sample_again
+********************************************************************************
+* Summary:
+*   Run a sample that is run again afterwards (warm-up and cold runs). In
+*   stateful RNN mode, the state is restored after the run, so the next run
+*   of the sample starts from the same state.
+*
+* Parameters:
+*   input: pointer to the sample
+*   cycles: returns the latency of the inference
+*
+* Return:
+*   cy_rslt_t: the status of the inference.
+*******************************************************************************/
+static cy_rslt_t ml_validation_run_sample_again(MTB_ML_DATA_T *input, uint64_t *cycles)
+{
+    cy_rslt_t result;
+
+#if defined(RNN_STREAMING) && defined(ML_STREAM_PIPELINE)
+    if (rnn_stateful)
+    {
+        ml_validation_rnn_checkpoint();
+        result = ml_validation_run_sample(input, cycles);
+        ml_validation_rnn_restore();
+        return result;
+    }
+#endif /* RNN_STREAMING && ML_STREAM_PIPELINE */
+
+    result = ml_validation_run_sample(input, cycles);
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: ml_validation_profile_sample
+********************************************************************************
+* Summary:
+*   Run and profile the inference of one sample. Before the first sample, the
+*   warm-up inferences are run. In cold mode, an extra inference is run with
+*   flushed caches. Warm-up and cold inferences are not included in the model
+*   and operator profiling.
+*
+* Parameters:
+*   input: pointer to the sample
+*   first_sample: true if this is the first sample of the regression
+*
+* Return:
+*   cy_rslt_t: the status of the inference.
+*******************************************************************************/
+static cy_rslt_t ml_validation_profile_sample(MTB_ML_DATA_T *input, bool first_sample)
+{
+    cy_rslt_t result;
+    uint64_t  cycles;
+
+    if (first_sample && (ML_VALIDATION_WARMUP_COUNT > 0u))
+    {
+        mtb_ml_model_profile_config(model_obj, MTB_ML_PROFILE_DISABLE);
+#if ML_PROFILE_OPS
+        op_profiler_enable(false);
+#endif
+
+        for (uint32_t i = 0; i < ML_VALIDATION_WARMUP_COUNT; i++)
+        {
+            result = ml_validation_run_sample_again(input, &cycles);
+            if (MTB_ML_RESULT_SUCCESS != result)
+            {
+                break;
+            }
+        }
+
+        mtb_ml_model_profile_config(model_obj, profile_config);
+#if ML_PROFILE_OPS
+        op_profiler_enable(true);
+#endif
+
+        if (MTB_ML_RESULT_SUCCESS != result)
+        {
+            return result;
+        }
+    }
+
+#if defined(ML_VALIDATION_COLD_MODE)
+    mtb_ml_model_profile_config(model_obj, MTB_ML_PROFILE_DISABLE);
+#if ML_PROFILE_OPS
+    op_profiler_enable(false);
+#endif
+    ml_validation_flush_caches();
+    result = ml_validation_run_sample_again(input, &cycles);
+    mtb_ml_model_profile_config(model_obj, profile_config);
+#if ML_PROFILE_OPS
+    op_profiler_enable(true);
+#endif
+
+    if (MTB_ML_RESULT_SUCCESS != result)
+    {
+        return result;
+    }
+    latency_histogram_record(&cold_latency, cycles);
+#endif /* ML_VALIDATION_COLD_MODE */
+
+    result = ml_validation_run_sample(input, &cycles);
+    if (MTB_ML_RESULT_SUCCESS == result)
+    {
+        latency_histogram_record(&steady_latency, cycles);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: ml_validation_init
+********************************************************************************
+* Summary:
+*   Initialize the Neural Network based on the given model and setup to start
+*   regression of the model and profiling configuration.
+*
+* Parameters:
+*   profile_cfg: profiling configuration
+*   model_bin: pointer to the model data
+*
+* Return:
+*   cy_rslt_t: the status of the initialization.
+*******************************************************************************/
+cy_rslt_t ml_validation_init(mtb_ml_profile_config_t profile_cfg,
+                             mtb_ml_model_bin_t *model_bin)
+{
+    cy_rslt_t result;
+
+    /* Initialize the neural network. The tensor arena is captured if the
+     * inference engine allocates it from the heap. */
+    mem_usage_capture_begin();
+    result = mtb_ml_model_init(model_bin,
+                               NULL,
+                               &model_obj);
+    mem_usage_capture_end();
+    if (CY_RSLT_SUCCESS != result)
+    {
+        printf("MTB ML initialization failure: %lu\r\n", (unsigned long) result);
+        return result;
+    }
+
+    mtb_ml_model_profile_config(model_obj, profile_cfg);
+    profile_config = profile_cfg;
+    first_inference_done = false;
+    inference_count = 0;
+
+    mtb_ml_model_get_output(model_obj, &result_buffer, &model_output_size);
+
+#if ML_INPUT_IN_PLACE
+    /* The samples are only written in the input tensor if the direct invoke
+     * runs the input tensor of model_obj */
+    model_input_in_place = (ML_MODEL_INPUT_PTR(model_obj) == model_obj->input);
+    if (!model_input_in_place)
+    {
+        printf("WARNING: the input tensor of the model is not its mtb_ml input, the samples are copied\r\n");
+    }
+#endif
+
+    /* Print information about the model */
+    mtb_ml_utils_print_model_info(model_obj);
+
+    return CY_RSLT_SUCCESS;
+}
+
+#ifndef USE_STREAM_DATA
+/*******************************************************************************
+* Function Name: ml_validation_reference_labels
+********************************************************************************
+* Summary:
+*   Find the class of the reference output of every regression sample, once.
+*   The label-only y data holds them already and its 8-bit or 16-bit
+*   indices are used in place.
+*
+* Parameters:
+*   num_samples: number of samples
+*
+* Return:
+*   cy_rslt_t: the status of the y data check and of the allocation.
+*******************************************************************************/
+static cy_rslt_t ml_validation_reference_labels(uint32_t num_samples)
+{
+    if (reference_labels != NULL)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+#if defined(ML_Y_DATA_LABELS)
+    const ml_y_labels_header_t *header = (const ml_y_labels_header_t *) ML_Y_LABELS_BIN(MODEL_NAME);
+    const uint8_t *indices = (const uint8_t *) &header[1];
+
+    if ((header->magic != ML_Y_LABELS_MAGIC) ||
+        (header->num_classes != (uint32_t) model_output_size) ||
+        (header->num_of_samples < num_samples) ||
+        ((header->index_size != 1u) && (header->index_size != 2u)) ||
+        ((header->score_size != 0u) && (header->score_size != sizeof(MTB_ML_DATA_T))))
+    {
+        printf("Label y data error, magic 0x%08x, %u samples, %u classes, index size %u, "
+               "score size %u, aborting...\r\n",
+               (unsigned) header->magic, (unsigned) header->num_of_samples,
+               (unsigned) header->num_classes, (unsigned) header->index_size,
+               (unsigned) header->score_size);
+        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+    }
+
+    if (header->score_size != 0u)
+    {
+        reference_scores = (const MTB_ML_DATA_T *)
+            &indices[((header->num_of_samples * header->index_size) + 3u) & ~3u];
+    }
+
+    reference_labels = indices;
+    reference_label_size = header->index_size;
+#else
+    uint16_t *labels = (uint16_t *) malloc(num_samples * sizeof(uint16_t));
+    if (labels == NULL)
+    {
+        printf("Reference label allocation failure\r\n");
+        return MTB_ML_RESULT_ALLOC_ERR;
+    }
+
+    const MTB_ML_DATA_T *output_reference = (const MTB_ML_DATA_T *) MTB_ML_MODEL_Y_DATA_BIN(MODEL_NAME);
+
+    for (uint32_t j = 0; j < num_samples; j++)
+    {
+        ml_topk(output_reference, model_output_size, 1u, &labels[j]);
+        output_reference += model_output_size;
+    }
+    reference_labels = labels;
+    reference_label_size = sizeof(uint16_t);
+#endif
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: ml_validation_reference_label
+********************************************************************************
+* Summary:
+*   Read the class of the reference output of a regression sample.
+*
+* Parameters:
+*   sample: index of the sample
+*
+* Return:
+*   uint16_t: the class of the reference output
+*******************************************************************************/
+static inline uint16_t ml_validation_reference_label(uint32_t sample)
+{
+    if (reference_label_size == sizeof(uint8_t))
+    {
+        return ((const uint8_t *) reference_labels)[sample];
+    }
+    return ((const uint16_t *) reference_labels)[sample];
+}
+
+#if defined(ML_X_DATA_COMPRESSED)
+/*******************************************************************************
+* Function Name: ml_validation_x_open
+********************************************************************************
+* Summary:
+*   Start reading the compressed x data, and allocate the buffer of a sample
+*   once.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   cy_rslt_t: the status of the x data check and of the allocation.
+*******************************************************************************/
+static cy_rslt_t ml_validation_x_open(void)
+{
+    if (!ml_x_compressed_open(&x_reader, ML_X_COMPRESSED_BIN(MODEL_NAME), sizeof(MTB_ML_DATA_T)))
+    {
+        printf("Compressed x data error, aborting...\r\n");
+        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+    }
+
+    if (x_scratch == NULL)
+    {
+        x_scratch = (MTB_ML_DATA_T *) malloc(x_reader.sample_size);
+        if (x_scratch == NULL)
+        {
+            printf("X data buffer allocation failure\r\n");
+            return MTB_ML_RESULT_ALLOC_ERR;
+        }
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: ml_validation_x_sample
+********************************************************************************
+* Summary:
+*   Decompress a sample of the x data into the sample buffer. The time spent
+*   is recorded apart from the inference.
+*
+* Parameters:
+*   index: index of the sample
+*
+* Return:
+*   MTB_ML_DATA_T *: the sample, NULL if the x data is corrupted
+*******************************************************************************/
+static MTB_ML_DATA_T *ml_validation_x_sample(uint32_t index)
+{
+    uint64_t start_tick;
+    uint64_t end_tick;
+    uint32_t consumed;
+    bool     decoded;
+
+    elapsed_timer_get_tick(&start_tick);
+    decoded = ml_x_compressed_read(&x_reader, index, (uint8_t *) x_scratch, &consumed);
+    elapsed_timer_get_tick(&end_tick);
+    if (!decoded)
+    {
+        printf("Compressed x data error at sample %u, aborting...\r\n", (unsigned) index);
+        return NULL;
+    }
+
+    latency_histogram_record(&x_decompress_latency, end_tick - start_tick);
+    x_decompress_in_bytes += consumed;
+    x_decompress_out_bytes += x_reader.sample_size;
+
+    return x_scratch;
+}
+#endif /* ML_X_DATA_COMPRESSED */
+
+/*******************************************************************************
+* Function Name: ml_validation_local_task
+********************************************************************************
+* Summary:
+*   Run the Neural Network Inference Engine based on the local data.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   cy_rslt_t: the status of the task execution.
+*******************************************************************************/
+cy_rslt_t ml_validation_local_task(void)
+{
+    /* Regression pointers */
+    MTB_ML_DATA_T  *input_reference;
+       
+    uint32_t     num_loop;
+    uint32_t     correct_result = 0;
+    uint32_t     correct_top_n = 0;
+    uint32_t     top_n;
+    uint16_t     top_classes[TOP_N_ACCURACY];
+    uint16_t     reference_label;
+#if defined(ML_Y_DATA_LABELS)
+    uint32_t     matched_scores = 0;
+#endif
+    bool         test_result;
+    uint32_t     total_count = 0;
+    cy_rslt_t    result;
+    int          file_input_size;
+    int          model_input_size = mtb_ml_model_get_input_size(model_obj);
+
+    /* Parse input data information: 
+     * - Data type (TFLM only)
+     * - Number of samples
+     * - Frame size
+     */
+#if defined(ML_X_DATA_COMPRESSED)
+    result = ml_validation_x_open();
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+    /* The samples are decompressed one at a time in the loop */
+    const ml_x_compressed_header_t *x_file_header = x_reader.header;
+#else
+    mtb_ml_x_file_header_t *x_file_header = (mtb_ml_x_file_header_t *) MTB_ML_MODEL_X_DATA_BIN(MODEL_NAME);
+
+    /* Point to regression data */
+    input_reference  = (MTB_ML_DATA_T *) (((uint32_t) x_file_header) + sizeof(*x_file_header));
+#endif
+
+    /* Get the number of loops for this regression */
+    num_loop = x_file_header->num_of_samples;
+
+    /* Get the number of inputs of the NN */
+    file_input_size = x_file_header->input_size;
+
+#if defined(RNN_STREAMING)
+
+    model_obj->recurrent_ts_size = x_file_header->recurrent_ts_size;
+
+    /* Check if it is a non-RNN model */
+    if (model_obj->recurrent_ts_size <= 0)
+    {
+        printf("This is not a RNN model (%d). Set the NN_RNN_MODEL variable to NO in the Makefile, aborting...\r\n", 
+            model_obj->recurrent_ts_size);
+        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+    }
+
+    /* If using RRN Model, check if the data time steps matches */
+    if ((file_input_size/model_obj->recurrent_ts_size) != model_input_size)
+    {
+        printf("Data size error, file input size=%d, model input size=%d recurrent time series size=%d, aborting...\r\n", 
+            file_input_size, model_input_size, model_obj->recurrent_ts_size);
+        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+    }
+#else
+    /* Check if the file input size matches the model input size */
+    if (file_input_size != model_input_size)
+    {
+        printf("Input buffer size error, file input size=%d, model input size=%d, aborting...\r\n", 
+                file_input_size, model_input_size);
+        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+    }
+#endif /* RNN_STREAMING */
+
+    result = ml_validation_reference_labels(num_loop);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+    top_n = ((uint32_t) model_output_size < TOP_N_ACCURACY) ? (uint32_t) model_output_size : TOP_N_ACCURACY;
+
+    ml_validation_profile_reset();
+
+    /* The following loop runs for number of examples used in regression */
+    for (int j = 0; j < num_loop; j++)
+    {
+#if defined(ML_X_DATA_COMPRESSED)
+        input_reference = ml_validation_x_sample((uint32_t) j);
+        if (input_reference == NULL)
+        {
+            return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+        }
+#endif
+        result = ml_validation_profile_sample(input_reference, (j == 0));
+
+        /* Check if the inferencing return any error */
+        if (MTB_ML_RESULT_SUCCESS != result)
+        {
+            return result;
+        }
+
+        /* Check if the results are accurate enough */
+        ml_topk(result_buffer, model_output_size, top_n, top_classes);
+        reference_label = ml_validation_reference_label(j);
+        if (top_classes[0] == reference_label)
+        {
+            correct_result++;
+        }
+        for (uint32_t i = 0; i < top_n; i++)
+        {
+            if (top_classes[i] == reference_label)
+            {
+                correct_top_n++;
+                break;
+            }
+        }
+#if defined(ML_Y_DATA_LABELS)
+        if (reference_scores != NULL)
+        {
+            float diff = (float) result_buffer[reference_label] - (float) reference_scores[j];
+
+            if ((diff <= ML_VALIDATION_SCORE_TOLERANCE) && (diff >= -ML_VALIDATION_SCORE_TOLERANCE))
+            {
+                matched_scores++;
+            }
+        }
+#endif
+
+#if !defined(ML_X_DATA_COMPRESSED)
+        /* Increment buffers */
+        input_reference  += file_input_size;
+#endif
+
+        total_count++;
+    }
+
+    /* Print PASS or FAIL with Accuracy percentage 
+     * Only for regression ... 
+     */
+    {
+        float success_rate;
+        float top_n_rate;
+
+        /* Check if total count is equal to ZERO */
+        if (total_count == 0)
+        {
+            success_rate = 0;
+            top_n_rate = 0;
+        }
+        else
+        {
+            success_rate = ((float) correct_result) * 100.0f / ((float) total_count);
+            top_n_rate = ((float) correct_top_n) * 100.0f / ((float) total_count);
+        }
+        
+        test_result = (success_rate >= SUCCESS_RATE);
+
+        ml_validation_profile_log();
+
+        printf("Top-1 accuracy: %3.2f%%, top-%u accuracy: %3.2f%%\r\n",
+               success_rate, (unsigned) top_n, top_n_rate);
+#if defined(ML_Y_DATA_LABELS)
+        if (reference_scores != NULL)
+        {
+            printf("Reference scores within %g: %u/%u\r\n", (double) ML_VALIDATION_SCORE_TOLERANCE,
+                   (unsigned) matched_scores, (unsigned) total_count);
+        }
+#endif
+        
+        printf("\r\n***************************************************\r\n");
+        if (test_result == true)
+        {
+            printf("PASS with accuracy percentage =%3.2f, total_cnt=%d", success_rate, (int) total_count);
+        }
+        else
+        {
+            printf("FAIL with accuracy percentage =%3.2f, total_cnt=%d", success_rate, (int) total_count);
+        }
+        printf("\r\n***************************************************\r\n");
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+#endif /* USE_STREAM_DATA */
+
+/*******************************************************************************
+* Function Name: ml_validation_stream_task
+********************************************************************************
+* Summary:
+*   Run the Neural Network Inference Engine based on the stream data.
+*
+* Parameters:
+*   iface: pointer to the streaming interface
+*
+* Return:
+*   cy_rslt_t: the status of the task execution.
+*******************************************************************************/
+cy_rslt_t ml_validation_stream_task(mtb_ml_stream_interface_t *iface)
+{
+    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+    uint64_t  wall_start_tick;
+    uint64_t  phase_start_tick;
+    uint64_t  phase_end_tick;
+    uint32_t  rx_buf_size;
+
+    /* Initialize the streaming interface */
+    result = mtb_ml_stream_init(iface, model_obj);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        printf("MTB ML streaming init failure: %lu\r\n", (unsigned long) result);
+        return result;
+    }
+
+    /* The RX buffer is kept across sessions, and only reallocated if a
+     * session needs a larger one */
+    rx_buf_size = (uint32_t) iface->input_size * sizeof(MTB_ML_DATA_T);
+    if (stream_rx_buf_size < rx_buf_size)
+    {
+        free(stream_rx_buf);
+        stream_rx_buf = (MTB_ML_DATA_T *) malloc(rx_buf_size);
+        stream_rx_buf_size = (stream_rx_buf != NULL) ? rx_buf_size : 0u;
+    }
+    if (stream_rx_buf == NULL)
+    {
+        printf("ERROR: Allocating memory for rx_buf\r\n");
+        return MTB_ML_RESULT_ALLOC_ERR;
+    }
+
+    /* Set slice length and initialize buffer */
+#if defined(RNN_STREAMING)
+    model_obj->recurrent_ts_size = iface->x_data_info.recurrent_ts_size;
+#endif /* RNN_STREAMING */
+
+    ml_validation_profile_reset();
+    elapsed_timer_get_tick(&wall_start_tick);
+
+    /* Do frame-by-frame (sample == frame) inference */
+    for (int i = 0; i < iface->x_data_info.num_of_samples; i++)
+    {
+        /* Receive the sample straight into the input tensor, unless it is
+         * run more than once */
+        MTB_ML_DATA_T *rx_buf = ml_validation_input_buffer(stream_rx_buf, (i == 0));
+
+        /* Get input data */
+        TRACE_EVENT(TRACE_EVENT_STREAM_RX_START, i);
+        elapsed_timer_get_tick(&phase_start_tick);
+        result = mtb_ml_stream_input_data(iface, rx_buf, DEFAULT_TIMEOUT_MS);
+        elapsed_timer_get_tick(&phase_end_tick);
+        TRACE_EVENT(TRACE_EVENT_STREAM_RX_END, i);
+        if(MTB_ML_RESULT_SUCCESS != result)
+        {
+            printf("ERROR: Failed to receive input data from host.\r\n");
+            break;
+        }
+        latency_histogram_record(&stream_rx_latency, phase_end_tick - phase_start_tick);
+        phase_start_tick = phase_end_tick;
+
+        /* Run the model */
+        result = ml_validation_profile_sample(rx_buf, (i == 0));
+        if (MTB_ML_RESULT_SUCCESS != result)
+        {
+            return result;
+        }
+
+        elapsed_timer_get_tick(&phase_end_tick);
+        latency_histogram_record(&stream_compute_latency, phase_end_tick - phase_start_tick);
+
+        /* Send output data */
+        TRACE_EVENT(TRACE_EVENT_STREAM_TX_START, i);
+        elapsed_timer_get_tick(&phase_start_tick);
+        result = mtb_ml_stream_output_data(iface, model_obj->output, DEFAULT_TIMEOUT_MS);
+        elapsed_timer_get_tick(&phase_end_tick);
+        TRACE_EVENT(TRACE_EVENT_STREAM_TX_END, i);
+        if(MTB_ML_RESULT_SUCCESS != result)
+        {
+            printf("ERROR: Failed to send output data to host\r\n");
+            return MTB_ML_RESULT_ALLOC_ERR;
+        }
+        latency_histogram_record(&stream_tx_latency, phase_end_tick - phase_start_tick);
+        stream_wall_cycles = phase_end_tick - wall_start_tick;
+    }
+
+    /* Generate profiling log if it is enabled */
+    result = ml_validation_profile_log();
+    if(MTB_ML_RESULT_SUCCESS != result)
+    {
+        printf("ERROR: Failed to generate profile log.\r\n");
+        return MTB_ML_RESULT_BAD_MODEL;
+    }
+
+    return mtb_ml_inform_host_done(iface, DEFAULT_TIMEOUT_MS);
+}
+
+#if defined(ML_STREAM_PIPELINE)
+/*******************************************************************************
+* Function Name: ml_validation_pipeline_alloc
+********************************************************************************
+* Summary:
+*   Allocate the sample buffers, the decoded and quantized sample buffers
+*   and the result buffers of the pipelined stream for the given codec,
+*   window and batch size.
+*   If the heap is too small, the window is halved down to
+*   STREAM_PROTO_DEFAULT_WINDOW, then the batch size is halved, until the
+*   buffers fit. The buffers are only reallocated if a session needs more
+*   memory than the previous one.
+*
+* Parameters:
+*   wire_bytes: size of one sample sent by the host, once decoded, in bytes
+*   sample_bytes: size of one sample in the input tensor in bytes
+*   reply_bytes: size of the reply to one sample in bytes
+*   codec: codec of the sample payloads (STREAM_CODEC_xxx)
+*   window: the requested window, returns the one allocated
+*   batch_size: the requested batch size, returns the one allocated
+*
+* Return:
+*   cy_rslt_t: the status of the allocation.
+*******************************************************************************/
+static cy_rslt_t ml_validation_pipeline_alloc(uint32_t wire_bytes, uint32_t sample_bytes,
+                                              uint32_t reply_bytes, uint32_t codec,
+                                              uint32_t *window, uint32_t *batch_size)
+{
+    uint32_t encoded_bytes = wire_bytes;
+    uint32_t decoded_bytes = 0;
+    uint32_t quantized_bytes = 0;
+    uint32_t slots = *window;
+    uint32_t batch = *batch_size;
+
+    /* A compressed sample may be a bit larger than the raw one, and is
+     * decoded into its own buffer */
+    if (codec != STREAM_CODEC_NONE)
+    {
+        encoded_bytes = STREAM_CODEC_MAX_SIZE(wire_bytes);
+        decoded_bytes = (wire_bytes + 3u) & ~3u;
+    }
+
+    /* A raw sample is quantized into its own buffer */
+    if (pipeline_quantize)
+    {
+        quantized_bytes = sample_bytes;
+    }
+
+    for (;;)
+    {
+        /* Keep the buffers following the sample buffers aligned */
+        uint32_t slot_size = ((encoded_bytes * batch) + 3u) & ~3u;
+        uint32_t pool_size = (slot_size * slots) + decoded_bytes + quantized_bytes +
+                             (reply_bytes * batch * slots);
+
+        if (pipeline_pool_size < pool_size)
+        {
+            free(pipeline_pool);
+            pipeline_pool_size = pool_size;
+            pipeline_pool = (uint8_t *) malloc(pool_size);
+        }
+
+        if (pipeline_pool != NULL)
+        {
+            /* The decoded and quantized samples and the results of a
+             * window of batches follow the sample buffers */
+            pipeline_decoded = (decoded_bytes != 0u) ? (MTB_ML_DATA_T *) &pipeline_pool[slot_size * slots] : NULL;
+            pipeline_quantized = (quantized_bytes != 0u) ?
+                                 (MTB_ML_DATA_T *) &pipeline_pool[(slot_size * slots) + decoded_bytes] : NULL;
+            pipeline_results = &pipeline_pool[(slot_size * slots) + decoded_bytes + quantized_bytes];
+            stream_proto_set_slots(pipeline_pool, slot_size, slots, batch);
+            *window = slots;
+            *batch_size = batch;
+            return MTB_ML_RESULT_SUCCESS;
+        }
+
+        pipeline_pool_size = 0;
+        if (slots > STREAM_PROTO_DEFAULT_WINDOW)
+        {
+            slots /= 2u;
+        }
+        else if (batch > 1u)
+        {
+            batch /= 2u;
+        }
+        else
+        {
+            return MTB_ML_RESULT_ALLOC_ERR;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: ml_validation_pipeline_reply
+********************************************************************************
+* Summary:
+*   Write the reply to the sample just run: the full model outputs, or the
+*   top classes with their quantized scores (STREAM_PROTO_TOP_K_ENTRY_SIZE
+*   bytes each: 16-bit index, little-endian, then 8-bit score).
+*
+* Parameters:
+*   dst: reply buffer
+*
+* Return:
+*   void
+*******************************************************************************/
+static void ml_validation_pipeline_reply(uint8_t *dst)
+{
+    uint16_t indices[ML_TOPK_MAX_K];
+
+    if (pipeline_top_k == 0u)
+    {
+        memcpy(dst, result_buffer, (uint32_t) model_output_size * sizeof(MTB_ML_DATA_T));
+        return;
+    }
 
-    return CY_RSLT_SUCCESS;
+    ml_topk(result_buffer, model_output_size, pipeline_top_k, indices);
+    for (uint32_t i = 0; i < pipeline_top_k; i++)
+    {
+        *dst++ = (uint8_t) indices[i];
+        *dst++ = (uint8_t) (indices[i] >> 8);
+        *dst++ = ml_topk_score(result_buffer[indices[i]]);
+    }
 }
 
-#ifndef USE_STREAM_DATA
 /*******************************************************************************
-* Function Name: ml_validation_local_task
+* Function Name: ml_validation_pipeline_quantize
 ********************************************************************************
 * Summary:
-*   Run the Neural Network Inference Engine based on the local data.
+*   Quantize a raw sample, and measure the time spent.
 *
 * Parameters:
-*   void
+*   raw: the raw sample (STREAM_PROTO_INPUT_UINT8 or STREAM_PROTO_INPUT_FLOAT)
+*   input: returns the quantized sample
+*   sample_size: number of inputs of the sample
 *
 * Return:
-*   cy_rslt_t: the status of the task execution.
+*   void
 *******************************************************************************/
-cy_rslt_t ml_validation_local_task(void)
+static void ml_validation_pipeline_quantize(const uint8_t *raw, MTB_ML_DATA_T *input,
+                                            uint32_t sample_size)
 {
-    /* Regression pointers */
-    MTB_ML_DATA_T  *input_reference;
-    MTB_ML_DATA_T  *output_reference;
-       
-    uint32_t     num_loop;
-    uint32_t     correct_result = 0;
-    bool         test_result;
-    uint32_t     total_count = 0;
-    cy_rslt_t    result;
-    int          file_input_size;
-    int          model_input_size = mtb_ml_model_get_input_size(model_obj);
-
-    /* Parse input data information: 
-     * - Data type (TFLM only)
-     * - Number of samples
-     * - Frame size
-     */
-    mtb_ml_x_file_header_t *x_file_header = (mtb_ml_x_file_header_t *) MTB_ML_MODEL_X_DATA_BIN(MODEL_NAME);
-
-    /* Point to regression data */
-    input_reference  = (MTB_ML_DATA_T *) (((uint32_t) x_file_header) + sizeof(*x_file_header));
-    output_reference = (MTB_ML_DATA_T *) MTB_ML_MODEL_Y_DATA_BIN(MODEL_NAME);
-
-    /* Get the number of loops for this regression */
-    num_loop = x_file_header->num_of_samples;
-
-    /* Get the number of inputs of the NN */
-    file_input_size = x_file_header->input_size;
-
-#if defined(RNN_STREAMING)
-
-    model_obj->recurrent_ts_size = x_file_header->recurrent_ts_size;
+    uint64_t start_tick;
+    uint64_t end_tick;
 
-    /* Check if it is a non-RNN model */
-    if (model_obj->recurrent_ts_size <= 0)
+    elapsed_timer_get_tick(&start_tick);
+    if (pipeline_input_format == STREAM_PROTO_INPUT_UINT8)
     {
-        printf("This is not a RNN model (%d). Set the NN_RNN_MODEL variable to NO in the Makefile, aborting...\r\n", 
-            model_obj->recurrent_ts_size);
-        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+        ml_quantize_u8(&pipeline_quant, raw, input, sample_size);
     }
-
-    /* If using RRN Model, check if the data time steps matches */
-    if ((file_input_size/model_obj->recurrent_ts_size) != model_input_size)
+    else
     {
-        printf("Data size error, file input size=%d, model input size=%d recurrent time series size=%d, aborting...\r\n", 
-            file_input_size, model_input_size, model_obj->recurrent_ts_size);
-        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+        ml_quantize_f32(&pipeline_quant, (const float *) raw, input, sample_size);
     }
+    elapsed_timer_get_tick(&end_tick);
+    latency_histogram_record(&stream_quantize_latency, end_tick - start_tick);
+    stream_quantize_inputs += sample_size;
+}
 
-    /* Allocate memory for the RNN input slice */
-    MTB_ML_DATA_T * input_slice = (MTB_ML_DATA_T *) malloc (model_input_size * sizeof(MTB_ML_DATA_T));
-
-    if (input_slice == NULL)
+/*******************************************************************************
+* Function Name: ml_validation_pipeline_record_shares
+********************************************************************************
+* Summary:
+*   Record the time spent receiving or transmitting a frame as the share of
+*   each of its samples, so the stream histograms count samples like the
+*   compute one, whatever the batch size.
+*
+* Parameters:
+*   hist: histogram of the phase
+*   cycles: time of the phase for the whole frame
+*   count: number of samples in the frame
+*
+* Return:
+*   void
+*******************************************************************************/
+static void ml_validation_pipeline_record_shares(latency_histogram_t *hist, uint64_t cycles,
+                                                 uint32_t count)
+{
+    /* The first sample takes the remainder, so the total is kept */
+    for (uint32_t i = 0; i < count; i++)
     {
-        printf("ERROR: Allocating memory for input slice\r\n");
-        return MTB_ML_RESULT_ALLOC_ERR;
+        latency_histogram_record(hist, (cycles / count) + ((i == 0u) ? (cycles % count) : 0u));
     }
+}
 
-#else
-    /* Check if the file input size matches the model input size */
-    if (file_input_size != model_input_size)
-    {
-        printf("Input buffer size error, file input size=%d, model input size=%d, aborting...\r\n", 
-                file_input_size, model_input_size);
-        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
-    }
-#endif /* RNN_STREAMING */
+/*******************************************************************************
+* Function Name: ml_validation_pipeline_run_frame
+********************************************************************************
+* Summary:
+*   Decode and quantize, if needed, and run every sample of a SAMPLE frame.
+*   The replies are collected in the given result buffer.
+*
+* Parameters:
+*   sample: the received frame
+*   codec: codec of the sample payloads (STREAM_CODEC_xxx)
+*   wire_bytes: size of one decoded sample in bytes
+*   sample_size: number of inputs of a sample
+*   reply_bytes: size of the reply to one sample in bytes
+*   max_count: largest number of samples the frame may hold
+*   results: result buffer of the batch
+*   first_sample: true if the frame holds the first sample of the session
+*   count: returns the number of samples run
+*
+* Return:
+*   cy_rslt_t: the status of the inferences.
+*******************************************************************************/
+static cy_rslt_t ml_validation_pipeline_run_frame(const stream_proto_sample_t *sample,
+                                                  uint32_t codec, uint32_t wire_bytes,
+                                                  uint32_t sample_size, uint32_t reply_bytes,
+                                                  uint32_t max_count, uint8_t *results,
+                                                  bool first_sample, uint32_t *count)
+{
+    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+    uint32_t  offset = 0;
+    uint64_t  start_tick;
+    uint64_t  end_tick;
 
-    /* The following loop runs for number of examples used in regression */
-    for (int j = 0; j < num_loop; j++)
+    *count = 0;
+
+    while (offset < sample->length)
     {
+        MTB_ML_DATA_T *input;
+        bool           first = first_sample && (*count == 0u);
 
-#if defined(RNN_STREAMING)
-        result = mtb_ml_model_rnn_reset_all_parameters(model_obj);
-        if (MTB_ML_RESULT_SUCCESS != result)
+        if (*count == max_count)
         {
-            printf("ERROR: failed to reset model parameters\r\n");
-            free(input_slice);
-            return MTB_ML_RESULT_INFERENCE_ERROR;
+            return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
         }
 
-        for (int i = 0; i < model_obj->recurrent_ts_size; i++)
+        if (codec == STREAM_CODEC_NONE)
         {
-            /* Input data is 2D array squashed to 1D array by Coretools */
-            for (int z = 0; z < model_input_size; z++)
+            /* Run the sample from its receive buffer: the next frames
+             * arrive while it runs, so it is not received in the input
+             * tensor */
+            if ((sample->length - offset) < wire_bytes)
             {
-                input_slice[z] = input_reference[i*model_input_size+z];
+                return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
             }
+            input = (MTB_ML_DATA_T *) &sample->data[offset];
+            offset += wire_bytes;
+        }
+        else
+        {
+            uint32_t consumed;
+            bool     decoded;
 
-            result = mtb_ml_model_run(model_obj, input_slice);
+            /* Decode straight into the input tensor, unless the sample is
+             * quantized afterwards or run more than once */
+            input = pipeline_quantize ? pipeline_decoded :
+                    ml_validation_input_buffer(pipeline_decoded, first);
 
-            /* Check if the inferencing return any error */
-            if (MTB_ML_RESULT_SUCCESS != result)
+            elapsed_timer_get_tick(&start_tick);
+            decoded = stream_codec_decode(codec, &sample->data[offset], sample->length - offset,
+                                          (uint8_t *) input, wire_bytes, &consumed);
+            elapsed_timer_get_tick(&end_tick);
+            if (!decoded)
             {
-                free(input_slice);
-                return result;
+                return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
             }
+            latency_histogram_record(&stream_decode_latency, end_tick - start_tick);
+            stream_decode_in_bytes += consumed;
+            stream_decode_out_bytes += wire_bytes;
+            offset += consumed;
         }
 
-#else
-        result = mtb_ml_model_run(model_obj, input_reference);
-
-        /* Check if the inferencing return any error */
-        if (MTB_ML_RESULT_SUCCESS != result)
+        if (pipeline_quantize)
         {
-            return result;
-        }
-#endif /* RNN_STREAMING */
+            /* Quantize straight into the input tensor, unless the sample is
+             * run more than once */
+            MTB_ML_DATA_T *quantized = ml_validation_input_buffer(pipeline_quantized, first);
 
-        /* Check if the results are accurate enough */
-        if (mtb_ml_utils_find_max(result_buffer, model_output_size) ==
-            mtb_ml_utils_find_max(output_reference, model_output_size))
-        {
-            correct_result++;
+            ml_validation_pipeline_quantize((const uint8_t *) input, quantized, sample_size);
+            input = quantized;
         }
 
-        /* Increment buffers */
-        input_reference  += file_input_size;
-        output_reference += model_output_size;
-
-        total_count++;
-    }
-
-#if defined(RNN_STREAMING)
-    free(input_slice);
-#endif /* RNN_STREAMING */
-
-    /* Print PASS or FAIL with Accuracy percentage 
-     * Only for regression ... 
-     */
-    {
-        float success_rate;
-
-        /* Check if total count is equal to ZERO */
-        if (total_count == 0)
-        {
-            success_rate = 0;
-        }
-        else
+        elapsed_timer_get_tick(&start_tick);
+        result = ml_validation_profile_sample(input, first);
+        if (MTB_ML_RESULT_SUCCESS != result)
         {
-            success_rate = ((float) correct_result) * 100.0f / ((float) total_count);
+            return result;
         }
-        
-        test_result = (success_rate >= SUCCESS_RATE);
+        ml_validation_pipeline_reply(&results[*count * reply_bytes]);
+        elapsed_timer_get_tick(&end_tick);
+        latency_histogram_record(&stream_compute_latency, end_tick - start_tick);
 
-        mtb_ml_model_profile_log(model_obj);
-        
-        printf("\r\n***************************************************\r\n");
-        if (test_result == true)
-        {
-            printf("PASS with accuracy percentage =%3.2f, total_cnt=%d", success_rate, (int) total_count);
-        }
-        else
-        {
-            printf("FAIL with accuracy percentage =%3.2f, total_cnt=%d", success_rate, (int) total_count);
-        }
-        printf("\r\n***************************************************\r\n");
+        (*count)++;
     }
 
-    return CY_RSLT_SUCCESS;
+    return result;
 }
-#endif /* USE_STREAM_DATA */
 
 /*******************************************************************************
-* Function Name: ml_validation_stream_task
+* Function Name: ml_validation_pipeline_task
 ********************************************************************************
 * Summary:
-*   Run the Neural Network Inference Engine based on the stream data.
+*   Run the Neural Network Inference Engine based on the pipelined stream.
+*   The host sends batches of up to STREAM_PROTO_MAX_BATCH samples per frame,
+*   and keeps a window of up to STREAM_PROTO_RX_SLOTS frames outstanding. The
+*   next frames are received in the UART interrupt while the current one is
+*   inferred, and the results of a batch are sent in one frame as soon as its
+*   last inference is done. Every frame sent to the host carries the
+*   cumulative ack of the samples whose buffers are free again. The samples
+*   can be compressed with one of the STREAM_CODEC_xxx codecs, or sent as raw
+*   uint8 or float values that are quantized on the device, and the
+*   replies can be reduced to the top classes of each sample. Corrupted or
+*   lost frames are asked again, so line noise does not stop the session.
+*   RNN models can keep their state from one sample to the next, so each
+*   sample only holds the new time steps of a sensor stream.
 *
 * Parameters:
-*   iface: pointer to the streaming interface
+*   void
 *
 * Return:
 *   cy_rslt_t: the status of the task execution.
 *******************************************************************************/
-cy_rslt_t ml_validation_stream_task(mtb_ml_stream_interface_t *iface)
+cy_rslt_t ml_validation_pipeline_task(void)
 {
-    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+    cy_rslt_t        result = MTB_ML_RESULT_SUCCESS;
+    stream_session_t session;
+    stream_info_t   *info = &pipeline_info;
+    stream_done_t   *done = &pipeline_done;
+    uint32_t         sample_size;
+    uint32_t         sample_bytes;
+    uint32_t         wire_bytes;
+    uint32_t         reply_bytes;
+    uint32_t         batch_size;
+    uint32_t         window;
+    uint32_t         codec;
+    float            input_scale;
+    int32_t          input_zero_point;
+    uint32_t         frame_count = 0;
+    uint64_t         wall_start_tick;
+    uint64_t         phase_start_tick;
+    uint64_t         phase_end_tick;
+    uint64_t         rx_cycles;
 
-    /* Initialize the streaming interface */
-    result = mtb_ml_stream_init(iface, model_obj);
-    if (CY_RSLT_SUCCESS != result)
+    if (!pipeline_port_ready)
     {
-        printf("MTB ML streaming init failure: %lu\r\n", (unsigned long) result);
-        return result;
+        result = stream_port_init(stream_proto_rx_bytes);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            printf("ERROR: Failed to open the stream port\r\n");
+            return result;
+        }
+        pipeline_port_ready = true;
     }
 
-    /* Alloc RX buf */
-    MTB_ML_DATA_T *rx_buf = (MTB_ML_DATA_T *) malloc(iface->input_size * sizeof(MTB_ML_DATA_T));
-    if(!rx_buf)
+    /* Wait for the host to start a session */
+    stream_proto_reset();
+    stream_proto_wait_control(STREAM_FRAME_SESSION, &session, sizeof(session),
+                              STREAM_PROTO_WAIT_FOREVER);
+    memset(done, 0, sizeof(*done));
+
+#if defined(RNN_STREAMING)
+    model_obj->recurrent_ts_size = session.recurrent_ts_size;
+    sample_size = (uint32_t) (model_obj->input_size * model_obj->recurrent_ts_size);
+
+    /* In stateful mode, the state is only reset here, at the start of the
+     * session, and the samples hold the next time steps of one sequence */
+    rnn_stateful = (session.rnn_stateful != 0u);
+    if (rnn_stateful)
     {
-        printf("ERROR: Allocating memory for rx_buf\r\n");
-        return MTB_ML_RESULT_ALLOC_ERR;
+        result = mtb_ml_model_rnn_reset_all_parameters(model_obj);
+        if (MTB_ML_RESULT_SUCCESS == result)
+        {
+            result = ml_validation_rnn_alloc_checkpoint();
+        }
+        if (MTB_ML_RESULT_SUCCESS != result)
+        {
+            printf("ERROR: Failed to set up the stateful RNN stream\r\n");
+            return result;
+        }
     }
+#else
+    sample_size = (uint32_t) model_obj->input_size;
+#endif /* RNN_STREAMING */
 
-    /* Set slice length and initialize buffer */
-#if defined(RNN_STREAMING)
-    model_obj->recurrent_ts_size = iface->x_data_info.recurrent_ts_size;
+    /* A host that does not ask for batches sends one sample per frame */
+    batch_size = session.batch_size;
+    if (batch_size == 0u)
+    {
+        batch_size = 1u;
+    }
+    else if (batch_size > STREAM_PROTO_MAX_BATCH)
+    {
+        batch_size = STREAM_PROTO_MAX_BATCH;
+    }
+
+    window = session.window;
+    if (window == 0u)
+    {
+        window = STREAM_PROTO_DEFAULT_WINDOW;
+    }
+    else if (window > STREAM_PROTO_RX_SLOTS)
+    {
+        window = STREAM_PROTO_RX_SLOTS;
+    }
 
-    /* Allocate memory for the RNN input slice */
-    MTB_ML_DATA_T * input_slice = (MTB_ML_DATA_T *) malloc (model_obj->input_size * sizeof(MTB_ML_DATA_T));
+    /* An unknown codec is refused, the host then sends raw samples */
+    codec = stream_codec_is_supported(session.codec) ? session.codec : STREAM_CODEC_NONE;
 
-    if (input_slice == NULL)
+    /* The host can ask for the top classes instead of the full outputs */
+    pipeline_top_k = session.reply_top_k;
+    if (pipeline_top_k > ML_TOPK_MAX_K)
     {
-        printf("ERROR: Allocating memory for input slice\r\n");
-        free(rx_buf);
-        return MTB_ML_RESULT_ALLOC_ERR;
+        pipeline_top_k = ML_TOPK_MAX_K;
     }
-#endif /* RNN_STREAMING */
+    if (pipeline_top_k > (uint32_t) model_output_size)
+    {
+        pipeline_top_k = (uint32_t) model_output_size;
+    }
+    reply_bytes = (pipeline_top_k != 0u) ? (pipeline_top_k * STREAM_PROTO_TOP_K_ENTRY_SIZE) :
+                  ((uint32_t) model_output_size * sizeof(MTB_ML_DATA_T));
 
-    /* Do frame-by-frame (sample == frame) inference */
-    for (int i = 0; i < iface->x_data_info.num_of_samples; i++)
+    /* The host can send raw uint8 or float values instead of samples in the
+     * data type of the model. An unknown format is refused. */
+    sample_bytes = sample_size * sizeof(MTB_ML_DATA_T);
+    pipeline_input_format = session.input_format;
+    if (pipeline_input_format == STREAM_PROTO_INPUT_UINT8)
     {
+        wire_bytes = sample_size;
+    }
+    else if (pipeline_input_format == STREAM_PROTO_INPUT_FLOAT)
+    {
+        wire_bytes = sample_size * sizeof(float);
+    }
+    else
+    {
+        pipeline_input_format = STREAM_PROTO_INPUT_MODEL;
+        wire_bytes = sample_bytes;
+    }
+    pipeline_quantize = (pipeline_input_format == STREAM_PROTO_INPUT_UINT8) ||
+                        ((pipeline_input_format == STREAM_PROTO_INPUT_FLOAT) &&
+                         (PIPELINE_DATA_TYPE != STREAM_PROTO_DATA_FLOAT));
+#if defined(COMPONENT_ML_FLOAT32)
+    input_scale = 1.0f;
+    input_zero_point = 0;
+#else
+    input_scale = model_obj->input_scale;
+    input_zero_point = (int32_t) model_obj->input_zero_point;
+#endif
+    ml_quantize_init(&pipeline_quant, input_scale, input_zero_point);
+
+    result = ml_validation_pipeline_alloc(wire_bytes, sample_bytes, reply_bytes, codec, &window, &batch_size);
+    if (MTB_ML_RESULT_SUCCESS != result)
+    {
+        printf("ERROR: Allocating memory for the sample buffers\r\n");
+        return result;
+    }
 
+    info->version = STREAM_PROTO_VERSION;
+    info->data_type = PIPELINE_DATA_TYPE;
+    info->elem_size = sizeof(MTB_ML_DATA_T);
+    info->sample_size = sample_size;
+    info->output_size = (uint32_t) model_output_size;
+    info->rx_slots = window;
+    info->batch_size = batch_size;
+    info->codec = codec;
+    info->reply_top_k = pipeline_top_k;
+    info->input_format = pipeline_input_format;
+    info->input_scale = input_scale;
+    info->input_zero_point = input_zero_point;
 #if defined(RNN_STREAMING)
-        result = mtb_ml_model_rnn_reset_all_parameters(model_obj);
-        if (MTB_ML_RESULT_SUCCESS != result)
-        {
-            printf("ERROR: failed to reset model parameters\r\n");
-            free(input_slice);
-            free(rx_buf);
-            return MTB_ML_RESULT_INFERENCE_ERROR;
-        }
-#endif /* RNN_STREAMING */
+    info->rnn_stateful = rnn_stateful ? 1u : 0u;
+#else
+    info->rnn_stateful = 0u;
+#endif
+    stream_proto_send(STREAM_FRAME_INFO, 0, info, sizeof(*info));
 
-        /* Get input data */
-        result = mtb_ml_stream_input_data(iface, rx_buf, DEFAULT_TIMEOUT_MS);
-        if(MTB_ML_RESULT_SUCCESS != result)
+    ml_validation_profile_reset();
+    stream_port_reset_tx_stats();
+    elapsed_timer_get_tick(&wall_start_tick);
+
+    while (done->num_samples < session.num_samples)
+    {
+        stream_proto_sample_t *sample;
+        uint8_t *results = &pipeline_results[(frame_count % window) * batch_size * reply_bytes];
+        uint32_t count = 0;
+        uint32_t max_count;
+        uint16_t seq;
+
+        /* Wait for the batch, most likely received during the previous one */
+        TRACE_EVENT(TRACE_EVENT_STREAM_RX_START, frame_count);
+        elapsed_timer_get_tick(&phase_start_tick);
+        sample = stream_proto_wait_sample(DEFAULT_TIMEOUT_MS);
+        elapsed_timer_get_tick(&phase_end_tick);
+        TRACE_EVENT(TRACE_EVENT_STREAM_RX_END, frame_count);
+        if (sample == NULL)
         {
-            printf("ERROR: Failed to receive input data from host.\r\n");
+            result = MTB_ML_RESULT_MISMATCH_DATA_TYPE;
             break;
         }
+        rx_cycles = phase_end_tick - phase_start_tick;
 
-#if defined(RNN_STREAMING)
-        for (int j = 0; j < model_obj->recurrent_ts_size; j++)
+        /* Frames are handed over in seq order, and only the last batch of
+         * the session can be shorter. Run the model on every sample, then
+         * give the buffer back. */
+        max_count = session.num_samples - done->num_samples;
+        if (max_count > batch_size)
         {
-            /* Input data is 2D array squashed to 1D array by Coretools */
-            for (int z = 0; z < model_obj->input_size; z++ )
-            {
-                input_slice[z] = ((MTB_ML_DATA_T *)rx_buf)[j * model_obj->input_size + z];
-            }
-
-            result = mtb_ml_model_run(model_obj, (MTB_ML_DATA_T *) input_slice);
-
-            if (result != MTB_ML_RESULT_SUCCESS)
-            {
-                free(rx_buf);
-                free(input_slice);
-                return result;
-            }
+            max_count = batch_size;
         }
-#else
-        /* Run the model */
-        result = mtb_ml_model_run(model_obj, (MTB_ML_DATA_T *) rx_buf);
+        if (sample->seq == (uint16_t) done->num_samples)
+        {
+            result = ml_validation_pipeline_run_frame(sample, codec, wire_bytes, sample_size, reply_bytes,
+                                                      max_count, results, (done->num_samples == 0u), &count);
+        }
+        else
+        {
+            result = MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+        }
+        if (MTB_ML_RESULT_MISMATCH_DATA_TYPE == result)
+        {
+            stream_port_flush();
+            printf("ERROR: Unexpected frame (seq=%u, %" PRIu32 " bytes)\r\n",
+                   (unsigned) sample->seq, sample->length);
+        }
+        seq = sample->seq;
+        stream_proto_release_sample((uint16_t) (done->num_samples + count));
         if (MTB_ML_RESULT_SUCCESS != result)
         {
-            free(rx_buf);
-            return result;
+            break;
         }
+        ml_validation_pipeline_record_shares(&stream_rx_latency, rx_cycles, count);
 
-#endif /* RNN_STREAMING */
+        /* Send the outputs of the batch */
+        TRACE_EVENT(TRACE_EVENT_STREAM_TX_START, frame_count);
+        elapsed_timer_get_tick(&phase_start_tick);
+        stream_proto_send(STREAM_FRAME_RESULT, seq, results, count * reply_bytes);
+        elapsed_timer_get_tick(&phase_end_tick);
+        TRACE_EVENT(TRACE_EVENT_STREAM_TX_END, frame_count);
+        ml_validation_pipeline_record_shares(&stream_tx_latency, phase_end_tick - phase_start_tick, count);
+        stream_wall_cycles = phase_end_tick - wall_start_tick;
 
-        /* Send output data */
-        result = mtb_ml_stream_output_data(iface, model_obj->output, DEFAULT_TIMEOUT_MS);
-        if(MTB_ML_RESULT_SUCCESS != result)
-        {
-            printf("ERROR: Failed to send output data to host\r\n");
-            free(rx_buf);
-            return MTB_ML_RESULT_ALLOC_ERR;
-        }
+        done->num_samples += count;
+        frame_count++;
     }
 
-    /* Free allocated memory */
-    free(rx_buf);
-#if defined(RNN_STREAMING)
-    free(input_slice);
-#endif
-
+    /* The log shares the UART with the stream: let the results out first */
+    stream_port_flush();
 
-    /* Generate profiling log if it is enabled */
-    result = mtb_ml_model_profile_log(model_obj);
-    if(MTB_ML_RESULT_SUCCESS != result)
+    if (MTB_ML_RESULT_SUCCESS != result)
     {
-        printf("ERROR: Failed to generate profile log.\r\n");
-        return MTB_ML_RESULT_BAD_MODEL;
+        printf("ERROR: Pipelined stream stopped after %" PRIu32 " samples (%lu)\r\n",
+               done->num_samples, (unsigned long) result);
     }
 
-    return mtb_ml_inform_host_done(iface, DEFAULT_TIMEOUT_MS);
+    /* Generate profiling log if it is enabled */
+    ml_validation_profile_log();
+
+    done->status = (uint32_t) result;
+    stream_proto_send(STREAM_FRAME_DONE, 0, done, sizeof(*done));
+    stream_port_flush();
+
+    return result;
 }
+#endif /* ML_STREAM_PIPELINE */
 
 /* [] END OF FILE */
\ No newline at end of file
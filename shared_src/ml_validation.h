@@ -53,6 +53,9 @@ cy_rslt_t ml_validation_init(mtb_ml_profile_config_t profile_cfg,
 cy_rslt_t ml_validation_local_task(void);
 #endif
 cy_rslt_t ml_validation_stream_task(mtb_ml_stream_interface_t *iface);
+#if defined(ML_STREAM_PIPELINE)
+cy_rslt_t ml_validation_pipeline_task(void);
+#endif
 
 #endif /* ML_VALIDATION_H */
 
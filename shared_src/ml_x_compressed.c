@@ -0,0 +1,206 @@
+/******************************************************************************
+* File Name:   ml_x_compressed.c
+*
+* Description: This file contains the reader of the compressed x regression
+*              data, which decompresses one sample at a time.
+*
+* Related Document: See README.md
+*
+*
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stddef.h>
+
+#include "ml_x_compressed.h"
+#include "stream_codec.h"
+
+/*******************************************************************************
+* Function Name: ml_x_compressed_expand
+********************************************************************************
+* Summary:
+*   Replace the table indices at the start of a sample buffer by their values.
+*   The buffer is filled from its end, so no index is overwritten before it is
+*   read.
+*
+* Parameters:
+*   reader: reader of the x data
+*   dst: sample buffer, starting with one index byte per element
+*
+* Return:
+*   bool: true if all the indices are in the table
+*******************************************************************************/
+static bool ml_x_compressed_expand(const ml_x_compressed_t *reader, uint8_t *dst)
+{
+    uint32_t count = reader->header->input_size;
+    uint32_t table_size = reader->header->table_size;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (dst[i] >= table_size)
+        {
+            return false;
+        }
+    }
+
+    if (reader->elem_size == sizeof(uint32_t))
+    {
+        const uint32_t *table = (const uint32_t *) reader->table;
+
+        for (uint32_t i = count; i > 0u; i--)
+        {
+            ((uint32_t *) dst)[i - 1u] = table[dst[i - 1u]];
+        }
+    }
+    else if (reader->elem_size == sizeof(uint16_t))
+    {
+        const uint16_t *table = (const uint16_t *) reader->table;
+
+        for (uint32_t i = count; i > 0u; i--)
+        {
+            ((uint16_t *) dst)[i - 1u] = table[dst[i - 1u]];
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            dst[i] = reader->table[dst[i]];
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ml_x_compressed_open
+********************************************************************************
+* Summary:
+*   Check the header of the compressed x data and set up a reader at its
+*   first sample.
+*
+* Parameters:
+*   reader: reader to set up
+*   data: compressed x data
+*   elem_size: size of an input element of the model in bytes
+*
+* Return:
+*   bool: true if the data can be read, false if the header is not valid
+*******************************************************************************/
+bool ml_x_compressed_open(ml_x_compressed_t *reader, const uint8_t *data, uint32_t elem_size)
+{
+    const ml_x_compressed_header_t *header = (const ml_x_compressed_header_t *) data;
+
+    if ((header->magic != ML_X_COMPRESSED_MAGIC) ||
+        !stream_codec_is_supported(header->codec) ||
+        (header->samples_per_block == 0u) ||
+        (header->table_size > 256u) ||
+        (header->num_blocks != ((header->num_of_samples + header->samples_per_block - 1u) /
+                                header->samples_per_block)))
+    {
+        return false;
+    }
+
+    reader->header      = header;
+    reader->table       = (header->table_size != 0u) ? (const uint8_t *) &header[1] : NULL;
+    reader->offsets     = (const uint32_t *) &data[sizeof(*header) +
+                                                   (((header->table_size * elem_size) + 3u) & ~3u)];
+    reader->blocks      = (const uint8_t *) &reader->offsets[header->num_blocks + 1u];
+    reader->elem_size   = elem_size;
+    reader->sample_size = header->input_size * elem_size;
+    reader->next_sample = 0;
+    reader->position    = 0;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ml_x_compressed_read
+********************************************************************************
+* Summary:
+*   Decompress a sample. Reading the samples in order continues from the last
+*   one. Otherwise the reader moves to the block of the sample and decodes the
+*   samples before it in the block. With a table, the indices are decoded
+*   first and replaced by their values in place.
+*
+* Parameters:
+*   reader: reader of the x data
+*   index: index of the sample
+*   dst: returns the sample, sample_size bytes
+*   consumed: returns the number of compressed bytes decoded
+*
+* Return:
+*   bool: true if the sample was decompressed, false if the data is corrupted
+*******************************************************************************/
+bool ml_x_compressed_read(ml_x_compressed_t *reader, uint32_t index, uint8_t *dst,
+                          uint32_t *consumed)
+{
+    const ml_x_compressed_header_t *header = reader->header;
+    uint32_t block;
+    uint32_t block_end;
+    uint32_t sample_bytes;
+    uint32_t decoded_size = (reader->table != NULL) ? header->input_size : reader->sample_size;
+
+    if (index >= header->num_of_samples)
+    {
+        return false;
+    }
+
+    block = index / header->samples_per_block;
+    if ((index != reader->next_sample) || ((index % header->samples_per_block) == 0u))
+    {
+        reader->next_sample = block * header->samples_per_block;
+        reader->position    = reader->offsets[block];
+    }
+    block_end = reader->offsets[block + 1u];
+
+    *consumed = 0;
+    while (reader->next_sample <= index)
+    {
+        if ((reader->position > block_end) ||
+            !stream_codec_decode(header->codec, &reader->blocks[reader->position],
+                                 block_end - reader->position, dst, decoded_size,
+                                 &sample_bytes))
+        {
+            return false;
+        }
+        reader->position += sample_bytes;
+        reader->next_sample++;
+        *consumed += sample_bytes;
+    }
+
+    return (reader->table == NULL) || ml_x_compressed_expand(reader, dst);
+}
+
+/* [] END OF FILE */
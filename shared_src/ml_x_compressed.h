@@ -0,0 +1,124 @@
+/******************************************************************************
+* File Name:   ml_x_compressed.h
+*
+* Description: This file contains the function prototypes and constants used
+*              in ml_x_compressed.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef ML_X_COMPRESSED_H
+#define ML_X_COMPRESSED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+/* First word of the compressed x data, "XZBK". Keep in sync with
+ * tools/x_data_compress.py */
+#define ML_X_COMPRESSED_MAGIC       (0x4B425A58u)
+
+/* File and array of the compressed x data of a model, generated next to the
+ * x data: <MODEL>_tflm_x_compressed_<NN_TYPE>.h and <MODEL>_x_compressed_bin */
+#define ML_X_COMPRESSED_STR(x)      #x
+#define ML_X_COMPRESSED_XSTR(x)     ML_X_COMPRESSED_STR(x)
+#if defined(COMPONENT_ML_FLOAT32)
+#define ML_X_COMPRESSED_FILE_(name) ML_X_COMPRESSED_XSTR(name##_tflm_x_compressed_float.h)
+#elif defined(COMPONENT_ML_INT16x8)
+#define ML_X_COMPRESSED_FILE_(name) ML_X_COMPRESSED_XSTR(name##_tflm_x_compressed_int16x8.h)
+#else
+#define ML_X_COMPRESSED_FILE_(name) ML_X_COMPRESSED_XSTR(name##_tflm_x_compressed_int8x8.h)
+#endif
+#define ML_X_COMPRESSED_FILE(name)  ML_X_COMPRESSED_FILE_(name)
+#define ML_X_COMPRESSED_BIN_(name)  name##_x_compressed_bin
+#define ML_X_COMPRESSED_BIN(name)   ML_X_COMPRESSED_BIN_(name)
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+/* Header of the compressed x data. The first fields are the ones of
+ * mtb_ml_x_file_header_t. It is followed by the table of values, if any
+ * (table_size elements, padded to 4 bytes), by the offsets of the blocks
+ * (num_blocks + 1 words, the last one is the size of the block data), then by
+ * the blocks. A block holds samples_per_block samples, each encoded on its
+ * own with the codec (STREAM_CODEC_xxx of stream_codec.h). With a table, a
+ * sample is encoded as one byte per element, the index of its value in the
+ * table. */
+typedef struct
+{
+    uint32_t magic;             /* ML_X_COMPRESSED_MAGIC */
+    uint32_t data_type;         /* Data type of the samples, as in the x data */
+    uint32_t num_of_samples;    /* Number of samples */
+    uint32_t input_size;        /* Input elements per sample */
+    int32_t  recurrent_ts_size; /* Time steps per sample (RNN), -1 otherwise */
+    uint32_t codec;             /* Codec of the samples */
+    uint32_t samples_per_block; /* Samples per block */
+    uint32_t num_blocks;        /* Number of blocks */
+    uint32_t table_size;        /* Values in the table, 0 without a table */
+} ml_x_compressed_header_t;
+
+/* Reader of the compressed x data */
+typedef struct
+{
+    const ml_x_compressed_header_t *header;      /* Header of the x data */
+    const uint8_t                  *table;       /* Table of values, NULL without a table */
+    const uint32_t                 *offsets;     /* Offsets of the blocks */
+    const uint8_t                  *blocks;      /* Block data */
+    uint32_t                        elem_size;   /* Size of an input element in bytes */
+    uint32_t                        sample_size; /* Size of a sample in bytes */
+    uint32_t                        next_sample; /* Sample at the read position */
+    uint32_t                        position;    /* Read position in the block data */
+} ml_x_compressed_t;
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+bool ml_x_compressed_open(ml_x_compressed_t *reader, const uint8_t *data, uint32_t elem_size);
+bool ml_x_compressed_read(ml_x_compressed_t *reader, uint32_t index, uint8_t *dst,
+                          uint32_t *consumed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ML_X_COMPRESSED_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,95 @@
+/******************************************************************************
+* File Name:   ml_y_labels.h
+*
+* Description: This file contains the layout of the label-only y regression
+*              data, generated by tools/y_data_to_labels.py.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef ML_Y_LABELS_H
+#define ML_Y_LABELS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+/* First word of the label-only y data, "YLBL". Keep in sync with
+ * tools/y_data_to_labels.py */
+#define ML_Y_LABELS_MAGIC           (0x4C424C59u)
+
+/* File and array of the label-only y data of a model, generated next to the
+ * x data: <MODEL>_tflm_y_labels_<NN_TYPE>.h and <MODEL>_y_labels_bin */
+#define ML_Y_LABELS_STR(x)          #x
+#define ML_Y_LABELS_XSTR(x)         ML_Y_LABELS_STR(x)
+#if defined(COMPONENT_ML_FLOAT32)
+#define ML_Y_LABELS_FILE_(name)     ML_Y_LABELS_XSTR(name##_tflm_y_labels_float.h)
+#elif defined(COMPONENT_ML_INT16x8)
+#define ML_Y_LABELS_FILE_(name)     ML_Y_LABELS_XSTR(name##_tflm_y_labels_int16x8.h)
+#else
+#define ML_Y_LABELS_FILE_(name)     ML_Y_LABELS_XSTR(name##_tflm_y_labels_int8x8.h)
+#endif
+#define ML_Y_LABELS_FILE(name)      ML_Y_LABELS_FILE_(name)
+#define ML_Y_LABELS_BIN_(name)      name##_y_labels_bin
+#define ML_Y_LABELS_BIN(name)       ML_Y_LABELS_BIN_(name)
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+/* Header of the label-only y data. It is followed by the class index of each
+ * sample (index_size bytes each), padded to 4 bytes, then by the reference
+ * output of the model for that class (score_size bytes each), if any. */
+typedef struct
+{
+    uint32_t magic;          /* ML_Y_LABELS_MAGIC */
+    uint32_t num_of_samples; /* Number of samples */
+    uint16_t num_classes;    /* Number of outputs of the model */
+    uint8_t  index_size;     /* Size of a class index: 1 or 2 bytes */
+    uint8_t  score_size;     /* Size of a reference score (the size of an output
+                              * element), 0 without scores */
+} ml_y_labels_header_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ML_Y_LABELS_H */
+
+/* [] END OF FILE */
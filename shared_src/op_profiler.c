@@ -0,0 +1,370 @@
+/******************************************************************************
+* File Name:   op_profiler.c
+*
+* Description: This file contains the implementation of the per-operator
+*              cycle profiler used by the interpreter-less inference engine.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "op_profiler.h"
+#include "elapsed_timer.h"
+#include "trace_buffer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+typedef struct
+{
+    const char *op_name;     /* Operator type of the node */
+    uint64_t    sum_cycles;  /* Accumulated cycles over all invocations */
+    uint64_t    peak_cycles; /* Highest cycles of a single invocation */
+    uint32_t    count;       /* Number of invocations */
+} op_profiler_node_t;
+
+typedef struct
+{
+    uint64_t macs;             /* Multiply-accumulates per invocation */
+    uint32_t weight_bytes;     /* Constant tensor bytes read per invocation */
+    uint32_t activation_bytes; /* Arena tensor bytes read and written per invocation */
+} op_profiler_node_info_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Per-node statistics */
+static op_profiler_node_t op_profiler_nodes[OP_PROFILER_MAX_NODES];
+
+/* Static per-node workload, described once at model init */
+static op_profiler_node_info_t op_profiler_node_info[OP_PROFILER_MAX_NODES];
+
+/* Number of nodes seen since the last reset */
+static uint32_t op_profiler_num_nodes;
+
+/* Tick captured when the current node started */
+static uint64_t op_profiler_start_tick;
+
+/* False while the node invocations are left out of the statistics */
+static bool op_profiler_enabled = true;
+
+/*******************************************************************************
+* Function Name: op_profiler_corrected
+********************************************************************************
+* Summary:
+*   Subtract the timer overhead from a number of cycles, saturating at zero.
+*
+* Parameters:
+*   cycles: raw number of cycles
+*   overhead: timer overhead included in the raw number of cycles
+*
+* Return:
+*   uint64_t: corrected number of cycles
+*******************************************************************************/
+static uint64_t op_profiler_corrected(uint64_t cycles, uint64_t overhead)
+{
+    return (cycles > overhead) ? (cycles - overhead) : 0u;
+}
+
+/*******************************************************************************
+* Function Name: op_profiler_reset
+********************************************************************************
+* Summary:
+*   Clear all the per-operator statistics. Call it before starting a new
+*   regression run.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void op_profiler_reset(void)
+{
+    memset(op_profiler_nodes, 0, sizeof(op_profiler_nodes));
+    op_profiler_num_nodes = 0;
+}
+
+/*******************************************************************************
+* Function Name: op_profiler_enable
+********************************************************************************
+* Summary:
+*   Enable or disable the per-operator statistics. Disable them around the
+*   inferences left out of the profiling, like the warm-up and cold ones.
+*
+* Parameters:
+*   enable: true to record the node invocations, false to ignore them
+*
+* Return:
+*   void
+*******************************************************************************/
+void op_profiler_enable(bool enable)
+{
+    op_profiler_enabled = enable;
+}
+
+/*******************************************************************************
+* Function Name: op_profiler_node_begin
+********************************************************************************
+* Summary:
+*   Mark the start of an operator node invocation.
+*
+* Parameters:
+*   node_idx: index of the node in the model graph
+*
+* Return:
+*   void
+*******************************************************************************/
+void op_profiler_node_begin(uint32_t node_idx)
+{
+    (void) node_idx;
+
+    if (!op_profiler_enabled)
+    {
+        return;
+    }
+
+    TRACE_EVENT(TRACE_EVENT_OP_START, node_idx);
+    elapsed_timer_get_tick(&op_profiler_start_tick);
+}
+
+/*******************************************************************************
+* Function Name: op_profiler_node_end
+********************************************************************************
+* Summary:
+*   Mark the end of an operator node invocation and accumulate the cycles
+*   spent since op_profiler_node_begin().
+*
+* Parameters:
+*   node_idx: index of the node in the model graph
+*   op_name: operator type of the node
+*
+* Return:
+*   void
+*******************************************************************************/
+void op_profiler_node_end(uint32_t node_idx, const char *op_name)
+{
+    uint64_t end_tick;
+    uint64_t cycles;
+    op_profiler_node_t *node;
+
+    if (!op_profiler_enabled)
+    {
+        return;
+    }
+
+    elapsed_timer_get_tick(&end_tick);
+    TRACE_EVENT(TRACE_EVENT_OP_END, node_idx);
+
+    if (node_idx >= OP_PROFILER_MAX_NODES)
+    {
+        return;
+    }
+
+    cycles = end_tick - op_profiler_start_tick;
+    node = &op_profiler_nodes[node_idx];
+
+    node->op_name = op_name;
+    node->sum_cycles += cycles;
+    node->count++;
+    if (cycles > node->peak_cycles)
+    {
+        node->peak_cycles = cycles;
+    }
+
+    if (node_idx >= op_profiler_num_nodes)
+    {
+        op_profiler_num_nodes = node_idx + 1;
+    }
+}
+
+/*******************************************************************************
+* Function Name: op_profiler_set_node_info
+********************************************************************************
+* Summary:
+*   Describe the workload of an operator node, used for the roofline report.
+*   It is kept across op_profiler_reset(), so call it once at model init.
+*
+* Parameters:
+*   node_idx: index of the node in the model graph
+*   macs: multiply-accumulates per invocation
+*   weight_bytes: constant tensor bytes read per invocation
+*   activation_bytes: arena tensor bytes read and written per invocation
+*
+* Return:
+*   void
+*******************************************************************************/
+void op_profiler_set_node_info(uint32_t node_idx, uint64_t macs,
+                               uint32_t weight_bytes, uint32_t activation_bytes)
+{
+    if (node_idx >= OP_PROFILER_MAX_NODES)
+    {
+        return;
+    }
+
+    op_profiler_node_info[node_idx].macs = macs;
+    op_profiler_node_info[node_idx].weight_bytes = weight_bytes;
+    op_profiler_node_info[node_idx].activation_bytes = activation_bytes;
+}
+
+/*******************************************************************************
+* Function Name: op_profiler_log_roofline
+********************************************************************************
+* Summary:
+*   Print the per-operator roofline report: MACs, achieved MACs/cycle and
+*   MMAC/s, weight and activation bytes/cycle, arithmetic intensity, and
+*   whether the node is compute-bound or memory-bound. Rates use the corrected
+*   average cycles.
+*
+* Parameters:
+*   overhead: timer overhead included in one node measurement
+*
+* Return:
+*   void
+*******************************************************************************/
+static void op_profiler_log_roofline(uint64_t overhead)
+{
+    float mhz = ((float) elapsed_timer_get_frequency()) / 1000000.0f;
+
+    printf("\r\nPer-operator roofline (ridge point %.2f MAC/B)\r\n",
+           (double) OP_PROFILER_RIDGE_POINT);
+    printf("%-4s %-24s %10s %10s %10s %10s %10s %10s %-8s\r\n",
+           "idx", "op", "MACs", "MAC/cyc", "MMAC/s", "wgt B/cyc", "act B/cyc", "MAC/B", "bound");
+
+    for (uint32_t i = 0; i < op_profiler_num_nodes; i++)
+    {
+        op_profiler_node_t *node = &op_profiler_nodes[i];
+        op_profiler_node_info_t *info = &op_profiler_node_info[i];
+        uint32_t total_bytes = info->weight_bytes + info->activation_bytes;
+        float cycles = 0.0f;
+        float intensity = 0.0f;
+
+        if (node->count != 0)
+        {
+            cycles = (float) op_profiler_corrected(node->sum_cycles / node->count, overhead);
+        }
+        if (cycles == 0.0f)
+        {
+            /* Avoid dividing by zero for nodes faster than the timer overhead */
+            cycles = 1.0f;
+        }
+        if (total_bytes != 0)
+        {
+            intensity = ((float) info->macs) / ((float) total_bytes);
+        }
+
+        printf("%-4" PRIu32 " %-24s %10" PRIu64 " %10.3f %10.2f %10.3f %10.3f %10.3f %-8s\r\n",
+               i,
+               (node->op_name != NULL) ? node->op_name : "-",
+               info->macs,
+               (double) (((float) info->macs) / cycles),
+               (double) (((float) info->macs) * mhz / cycles),
+               (double) (((float) info->weight_bytes) / cycles),
+               (double) (((float) info->activation_bytes) / cycles),
+               (double) intensity,
+               (intensity >= OP_PROFILER_RIDGE_POINT) ? "compute" : "memory");
+    }
+}
+
+/*******************************************************************************
+* Function Name: op_profiler_log
+********************************************************************************
+* Summary:
+*   Print the per-operator report: op index, op type, average and peak cycles,
+*   and the share of the total operator time. The average and peak cycles are
+*   shown both raw and corrected by the calibrated timer overhead.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void op_profiler_log(void)
+{
+    uint64_t total_cycles = 0;
+    uint64_t overhead;
+
+    if (op_profiler_num_nodes == 0)
+    {
+        return;
+    }
+
+    elapsed_timer_get_overhead(NULL, &overhead);
+
+    for (uint32_t i = 0; i < op_profiler_num_nodes; i++)
+    {
+        total_cycles += op_profiler_corrected(op_profiler_nodes[i].sum_cycles,
+                                              overhead * op_profiler_nodes[i].count);
+    }
+
+    printf("\r\nPer-operator profile (%" PRIu32 " nodes, timer overhead %" PRIu64 " cycles)\r\n",
+           op_profiler_num_nodes, overhead);
+    printf("%-4s %-24s %10s %10s %10s %10s %8s\r\n",
+           "idx", "op", "avg raw", "avg corr", "peak raw", "peak corr", "share");
+
+    for (uint32_t i = 0; i < op_profiler_num_nodes; i++)
+    {
+        op_profiler_node_t *node = &op_profiler_nodes[i];
+        uint64_t avg_cycles = 0;
+        float share = 0.0f;
+
+        if (node->count != 0)
+        {
+            avg_cycles = node->sum_cycles / node->count;
+        }
+        if (total_cycles != 0)
+        {
+            share = ((float) op_profiler_corrected(node->sum_cycles, overhead * node->count)) * 100.0f /
+                    ((float) total_cycles);
+        }
+
+        printf("%-4" PRIu32 " %-24s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %7.2f%%\r\n",
+               i,
+               (node->op_name != NULL) ? node->op_name : "-",
+               avg_cycles,
+               op_profiler_corrected(avg_cycles, overhead),
+               node->peak_cycles,
+               op_profiler_corrected(node->peak_cycles, overhead),
+               share);
+    }
+
+    op_profiler_log_roofline(overhead);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,82 @@
+/******************************************************************************
+* File Name:   op_profiler.h
+*
+* Description: This file contains the function prototypes and constants used
+*              in op_profiler.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef OP_PROFILER_H
+#define OP_PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+/* Maximum number of operator nodes that can be profiled */
+#define OP_PROFILER_MAX_NODES   (64u)
+
+/* Arithmetic intensity (MACs per byte moved) above which a node is reported
+ * as compute-bound. Tune it to the ratio of the peak MAC rate to the memory
+ * bandwidth of the memory the model is placed in. */
+#ifndef OP_PROFILER_RIDGE_POINT
+#define OP_PROFILER_RIDGE_POINT (1.0f)
+#endif
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+void op_profiler_reset(void);
+void op_profiler_enable(bool enable);
+void op_profiler_node_begin(uint32_t node_idx);
+void op_profiler_node_end(uint32_t node_idx, const char *op_name);
+void op_profiler_log(void);
+void op_profiler_set_node_info(uint32_t node_idx, uint64_t macs,
+                               uint32_t weight_bytes, uint32_t activation_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OP_PROFILER_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,230 @@
+/******************************************************************************
+* File Name:   stack_usage.c
+*
+* Description: This file contains the implementation of the stack high-water
+*              mark measurement. The unused part of each stack is painted
+*              when it is registered and scanned when the report is printed.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "stack_usage.h"
+
+#if !defined(ML_PROFILER_HOST)
+#include "cybsp.h"
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+typedef struct
+{
+    const char *name;  /* Name of the task using the stack */
+    uint32_t   *limit; /* Lowest address of the stack */
+    uint32_t   *top;   /* Address just above the stack */
+} stack_usage_task_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Registered stacks */
+static stack_usage_task_t stack_usage_tasks[STACK_USAGE_MAX_TASKS];
+static uint32_t stack_usage_num_tasks;
+
+#if !defined(ML_PROFILER_HOST)
+/* Main stack bounds, provided by the linker */
+#if defined(__ARMCC_VERSION)
+extern uint32_t Image$$ARM_LIB_STACK$$ZI$$Base[];
+extern uint32_t Image$$ARM_LIB_STACK$$ZI$$Limit[];
+#define STACK_USAGE_MAIN_LIMIT  (Image$$ARM_LIB_STACK$$ZI$$Base)
+#define STACK_USAGE_MAIN_TOP    (Image$$ARM_LIB_STACK$$ZI$$Limit)
+#elif defined(__ICCARM__)
+#pragma section="CSTACK"
+#define STACK_USAGE_MAIN_LIMIT  (__section_begin("CSTACK"))
+#define STACK_USAGE_MAIN_TOP    (__section_end("CSTACK"))
+#else
+extern uint32_t __StackLimit[];
+extern uint32_t __StackTop[];
+#define STACK_USAGE_MAIN_LIMIT  (__StackLimit)
+#define STACK_USAGE_MAIN_TOP    (__StackTop)
+#endif
+#endif /* ML_PROFILER_HOST */
+
+/*******************************************************************************
+* Function Name: stack_usage_register
+********************************************************************************
+* Summary:
+*   Register a stack and paint its unused part. If the stack is the one in
+*   use, only the part below the current stack pointer is painted, with the
+*   interrupts masked. Register a thread stack before the thread is started to
+*   paint all of it.
+*
+* Parameters:
+*   task_name: name of the task using the stack
+*   limit: lowest address of the stack
+*   top: address just above the stack
+*
+* Return:
+*   bool: true if the stack is registered
+*******************************************************************************/
+bool stack_usage_register(const char *task_name, void *limit, void *top)
+{
+    volatile uint32_t sp_marker = 0;
+    uintptr_t paint_end = (uintptr_t) top;
+    uintptr_t sp = (uintptr_t) &sp_marker;
+    stack_usage_task_t *task;
+
+    if ((stack_usage_num_tasks >= STACK_USAGE_MAX_TASKS) ||
+        ((uintptr_t) limit >= (uintptr_t) top))
+    {
+        return false;
+    }
+
+    /* Do not paint over the live frames of the current stack */
+    if ((sp >= (uintptr_t) limit) && (sp < (uintptr_t) top))
+    {
+        paint_end = sp - STACK_USAGE_PAINT_MARGIN;
+    }
+
+    /* Mask the interrupts while painting: their frames are pushed on the main
+     * stack, below the current stack pointer */
+#if !defined(ML_PROFILER_HOST)
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+#endif
+    for (volatile uint32_t *word = (uint32_t *) limit; (uintptr_t) word < paint_end; word++)
+    {
+        *word = STACK_USAGE_PAINT_PATTERN;
+    }
+#if !defined(ML_PROFILER_HOST)
+    if (primask == 0U)
+    {
+        __enable_irq();
+    }
+#endif
+
+    task = &stack_usage_tasks[stack_usage_num_tasks];
+    task->name = task_name;
+    task->limit = (uint32_t *) limit;
+    task->top = (uint32_t *) top;
+    stack_usage_num_tasks++;
+
+    return true;
+}
+
+#if !defined(ML_PROFILER_HOST)
+/*******************************************************************************
+* Function Name: stack_usage_register_main
+********************************************************************************
+* Summary:
+*   Register and paint the main stack, using the bounds from the linker. Call
+*   it at the start of the task, before the deep call chains run.
+*
+* Parameters:
+*   task_name: name of the task running on the main stack
+*
+* Return:
+*   bool: true if the stack is registered
+*******************************************************************************/
+bool stack_usage_register_main(const char *task_name)
+{
+    return stack_usage_register(task_name, (void *) STACK_USAGE_MAIN_LIMIT,
+                                (void *) STACK_USAGE_MAIN_TOP);
+}
+#endif /* ML_PROFILER_HOST */
+
+/*******************************************************************************
+* Function Name: stack_usage_get_peak
+********************************************************************************
+* Summary:
+*   Get the peak depth of a stack, from its top down to the lowest word that
+*   is no longer painted.
+*
+* Parameters:
+*   task_idx: index of the stack, in registration order
+*
+* Return:
+*   uint32_t: peak depth in bytes, 0 if the index is not valid
+*******************************************************************************/
+uint32_t stack_usage_get_peak(uint32_t task_idx)
+{
+    const volatile uint32_t *word;
+    stack_usage_task_t *task;
+
+    if (task_idx >= stack_usage_num_tasks)
+    {
+        return 0;
+    }
+
+    task = &stack_usage_tasks[task_idx];
+    word = task->limit;
+    while ((word < task->top) && (*word == STACK_USAGE_PAINT_PATTERN))
+    {
+        word++;
+    }
+
+    return (uint32_t) ((uintptr_t) task->top - (uintptr_t) word);
+}
+
+/*******************************************************************************
+* Function Name: stack_usage_log
+********************************************************************************
+* Summary:
+*   Print the size, peak depth and free space of every registered stack.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void stack_usage_log(void)
+{
+    for (uint32_t i = 0; i < stack_usage_num_tasks; i++)
+    {
+        stack_usage_task_t *task = &stack_usage_tasks[i];
+        uint32_t size = (uint32_t) ((uintptr_t) task->top - (uintptr_t) task->limit);
+        uint32_t peak = stack_usage_get_peak(i);
+
+        printf("  stack %s: size=%" PRIu32 " peak=%" PRIu32 " free=%" PRIu32 "\r\n",
+               (task->name != NULL) ? task->name : "-", size, peak, size - peak);
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,81 @@
+/******************************************************************************
+* File Name:   stack_usage.h
+*
+* Description: This file contains the public interface of the stack
+*              high-water mark measurement.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef STACK_USAGE_H
+#define STACK_USAGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+/* Maximum number of stacks that can be measured */
+#define STACK_USAGE_MAX_TASKS       (4u)
+
+/* Word written over the unused part of a stack */
+#define STACK_USAGE_PAINT_PATTERN   (0x5A3C96E1u)
+
+/* Bytes left unpainted below the current stack pointer, to protect the frame
+ * of the painting function */
+#define STACK_USAGE_PAINT_MARGIN    (128u)
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+bool     stack_usage_register(const char *task_name, void *limit, void *top);
+#if !defined(ML_PROFILER_HOST)
+bool     stack_usage_register_main(const char *task_name);
+#endif
+uint32_t stack_usage_get_peak(uint32_t task_idx);
+void     stack_usage_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STACK_USAGE_H */
+
+/* [] END OF FILE */
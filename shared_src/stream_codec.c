@@ -0,0 +1,158 @@
+/******************************************************************************
+* File Name:   stream_codec.c
+*
+* Description: This file contains the decoders of the compressed sample
+*              payloads of the pipelined stream protocol.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "stream_codec.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+/* Token bytes from this value start a zero run */
+#define STREAM_CODEC_RUN_TOKEN      (0x80u)
+
+/*******************************************************************************
+* Function Name: stream_codec_is_supported
+********************************************************************************
+* Summary:
+*   Check if a codec can be decoded.
+*
+* Parameters:
+*   codec: STREAM_CODEC_xxx
+*
+* Return:
+*   bool: true if the codec is supported
+*******************************************************************************/
+bool stream_codec_is_supported(uint32_t codec)
+{
+    return (codec == STREAM_CODEC_NONE) || (codec == STREAM_CODEC_ZRLE) ||
+           (codec == STREAM_CODEC_DELTA_ZRLE);
+}
+
+/*******************************************************************************
+* Function Name: stream_codec_decode
+********************************************************************************
+* Summary:
+*   Decode one sample. The tokens are read until the sample is complete, so
+*   the samples of a batch can follow each other in the same payload. With
+*   DELTA_ZRLE, the deltas are summed up while decoding, in a single pass.
+*
+* Parameters:
+*   codec: STREAM_CODEC_xxx
+*   src: encoded bytes
+*   src_size: number of encoded bytes available
+*   dst: decoded sample
+*   dst_size: size of the sample in bytes
+*   consumed: returns the number of encoded bytes of the sample
+*
+* Return:
+*   bool: true if the sample was decoded, false if the data is corrupted
+*******************************************************************************/
+bool stream_codec_decode(uint32_t codec, const uint8_t *src, uint32_t src_size,
+                         uint8_t *dst, uint32_t dst_size, uint32_t *consumed)
+{
+    uint32_t in = 0;
+    uint32_t out = 0;
+    uint8_t  prev = 0;
+    bool     delta = (codec == STREAM_CODEC_DELTA_ZRLE);
+
+    if (codec == STREAM_CODEC_NONE)
+    {
+        if (src_size < dst_size)
+        {
+            return false;
+        }
+        memcpy(dst, src, dst_size);
+        *consumed = dst_size;
+        return true;
+    }
+
+    while (out < dst_size)
+    {
+        uint32_t token;
+        uint32_t length;
+
+        if (in >= src_size)
+        {
+            return false;
+        }
+        token = src[in++];
+
+        if (token >= STREAM_CODEC_RUN_TOKEN)
+        {
+            /* A run of zero deltas repeats the previous byte */
+            length = token - STREAM_CODEC_RUN_TOKEN + 1u;
+            if (length > (dst_size - out))
+            {
+                return false;
+            }
+            memset(&dst[out], delta ? prev : 0, length);
+        }
+        else
+        {
+            length = token + 1u;
+            if ((length > (dst_size - out)) || (length > (src_size - in)))
+            {
+                return false;
+            }
+            if (delta)
+            {
+                for (uint32_t i = 0; i < length; i++)
+                {
+                    prev = (uint8_t) (prev + src[in + i]);
+                    dst[out + i] = prev;
+                }
+            }
+            else
+            {
+                memcpy(&dst[out], &src[in], length);
+            }
+            in += length;
+        }
+        out += length;
+    }
+
+    *consumed = in;
+    return true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/******************************************************************************
+* File Name:   stream_codec.h
+*
+* Description: This file contains the function prototypes and constants used
+*              in stream_codec.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef STREAM_CODEC_H
+#define STREAM_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+/* Codecs of the sample payloads. Keep in sync with tools/ml_stream_host.py
+ * - NONE: the raw sample bytes
+ * - ZRLE: zero-run length encoding. A token byte below 0x80 is followed by
+ *   (token + 1) literal bytes; a token byte from 0x80 stands for
+ *   (token - 0x7F) zero bytes.
+ * - DELTA_ZRLE: every byte is replaced by its difference to the previous
+ *   byte of the sample (modulo 256, the first one to 0), then the result is
+ *   zero-run length encoded. Constant runs of any value become zero runs. */
+#define STREAM_CODEC_NONE           (0u)
+#define STREAM_CODEC_ZRLE           (1u)
+#define STREAM_CODEC_DELTA_ZRLE     (2u)
+
+/* Largest encoded size of a sample of the given size: one token per 128
+ * literal bytes at worst */
+#define STREAM_CODEC_MAX_SIZE(size) ((size) + (((size) + 127u) / 128u))
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+bool stream_codec_is_supported(uint32_t codec);
+bool stream_codec_decode(uint32_t codec, const uint8_t *src, uint32_t src_size,
+                         uint8_t *dst, uint32_t dst_size, uint32_t *consumed);
+
+#endif /* STREAM_CODEC_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,636 @@
+/******************************************************************************
+* File Name:   stream_port.c
+*
+* Description: This file contains the implementation of the byte transport
+*              used by the pipelined stream protocol. On the device, the
+*              debug UART receives in an interrupt, so the data of the next
+*              sample arrives while the current one is inferred. On a host
+*              build, a reader thread plays the role of the interrupt on a
+*              file descriptor (pty, socket or serial port). The writes go
+*              through a transmit queue, drained by the UART transmit
+*              interrupt (a writer thread on a host build), so the next
+*              inference starts while the results are sent.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "stream_port.h"
+
+#if defined(ML_PROFILER_HOST)
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#else
+#include "cybsp.h"
+#include "cy_pdl.h"
+#include "elapsed_timer.h"
+#endif
+
+#include <stddef.h>
+#include <string.h>
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+/* Size of the chunks passed to the receive callback */
+#define STREAM_PORT_RX_CHUNK_SIZE   (64u)
+
+/* Position of a transmit queue index in the queue */
+#define STREAM_PORT_TX_MASK         (STREAM_PORT_TX_QUEUE_SIZE - 1u)
+
+#if !defined(ML_PROFILER_HOST)
+#define STREAM_PORT_UART_HW         CYBSP_DEBUG_UART_HW
+#define STREAM_PORT_UART_IRQ        CYBSP_DEBUG_UART_IRQ
+#endif
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Receive callback */
+static stream_port_rx_callback_t stream_port_rx_callback;
+
+/* Number of receive overflows (bytes lost by the hardware) */
+static volatile uint32_t stream_port_overflows;
+
+/* Transmit queue. The indices run freely: the writer only moves the head,
+ * the interrupt (or writer thread) draining the queue only moves the tail. */
+static uint8_t           stream_port_tx_queue[STREAM_PORT_TX_QUEUE_SIZE];
+static volatile uint32_t stream_port_tx_head;
+static volatile uint32_t stream_port_tx_tail;
+static uint32_t          stream_port_tx_high_water;
+static uint32_t          stream_port_tx_stalls;
+
+#if defined(ML_PROFILER_HOST)
+/* File descriptor of the port, its reader and writer threads */
+static int stream_port_fd = -1;
+static pthread_t stream_port_reader;
+static pthread_t stream_port_writer;
+static bool stream_port_reader_started;
+
+/* Wakes up the writer thread on new bytes, and the application when bytes
+ * are out of the queue */
+static pthread_mutex_t stream_port_tx_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  stream_port_tx_cond = PTHREAD_COND_INITIALIZER;
+
+/* True while the writer thread writes bytes it took from the queue */
+static bool stream_port_tx_busy;
+
+/* Emulated line rate in bit/s, 0 if the port is not throttled */
+static uint32_t stream_port_baud;
+#endif
+
+#if defined(ML_PROFILER_HOST)
+/*******************************************************************************
+* Function Name: stream_port_pace
+********************************************************************************
+* Summary:
+*   Wait for the time a UART at the emulated line rate (10 bits per byte)
+*   would take to transfer the bytes. The time is accumulated in a deadline,
+*   so the sleep granularity does not slow the line down.
+*
+* Parameters:
+*   deadline: end of the previous transfer in the same direction
+*   size: number of bytes transferred
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_port_pace(struct timespec *deadline, uint32_t size)
+{
+    struct timespec now;
+    uint64_t line_ns;
+
+    if (stream_port_baud == 0u)
+    {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if ((deadline->tv_sec < now.tv_sec) ||
+        ((deadline->tv_sec == now.tv_sec) && (deadline->tv_nsec < now.tv_nsec)))
+    {
+        *deadline = now;
+    }
+
+    line_ns = ((uint64_t) size * 10u * 1000000000u) / stream_port_baud;
+    line_ns += (uint64_t) deadline->tv_nsec;
+    deadline->tv_sec += (time_t) (line_ns / 1000000000u);
+    deadline->tv_nsec = (long) (line_ns % 1000000000u);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL) == EINTR)
+    {
+    }
+}
+
+/*******************************************************************************
+* Function Name: stream_port_reader_thread
+********************************************************************************
+* Summary:
+*   Read the port and pass the received bytes to the receive callback.
+*
+* Parameters:
+*   arg: unused
+*
+* Return:
+*   void *: always NULL
+*******************************************************************************/
+static void *stream_port_reader_thread(void *arg)
+{
+    uint8_t chunk[STREAM_PORT_RX_CHUNK_SIZE];
+    struct timespec deadline = { 0 };
+
+    (void) arg;
+
+    for (;;)
+    {
+        ssize_t size = read(stream_port_fd, chunk, sizeof(chunk));
+
+        if (size > 0)
+        {
+            /* Deliver the bytes when the last one would be out of the UART */
+            stream_port_pace(&deadline, (uint32_t) size);
+            stream_port_rx_callback(chunk, (uint32_t) size);
+        }
+        else if ((size == 0) || (errno != EINTR))
+        {
+            /* The other end closed the port, wait for it to come back */
+            usleep(10000);
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: stream_port_writer_thread
+********************************************************************************
+* Summary:
+*   Drain the transmit queue to the port.
+*
+* Parameters:
+*   arg: unused
+*
+* Return:
+*   void *: always NULL
+*******************************************************************************/
+static void *stream_port_writer_thread(void *arg)
+{
+    struct timespec deadline = { 0 };
+
+    (void) arg;
+
+    pthread_mutex_lock(&stream_port_tx_mutex);
+    for (;;)
+    {
+        uint32_t tail = stream_port_tx_tail;
+        uint32_t size = stream_port_tx_head - tail;
+        const uint8_t *bytes = &stream_port_tx_queue[tail & STREAM_PORT_TX_MASK];
+
+        if (size == 0u)
+        {
+            pthread_cond_wait(&stream_port_tx_cond, &stream_port_tx_mutex);
+            continue;
+        }
+
+        /* Up to the end of the queue, the rest comes next time */
+        if (size > (STREAM_PORT_TX_QUEUE_SIZE - (tail & STREAM_PORT_TX_MASK)))
+        {
+            size = STREAM_PORT_TX_QUEUE_SIZE - (tail & STREAM_PORT_TX_MASK);
+        }
+        stream_port_tx_busy = true;
+        pthread_mutex_unlock(&stream_port_tx_mutex);
+
+        /* Take as long as the UART would */
+        stream_port_pace(&deadline, size);
+        for (uint32_t left = size; left > 0u;)
+        {
+            ssize_t written = write(stream_port_fd, bytes, left);
+
+            if (written > 0)
+            {
+                bytes += written;
+                left -= (uint32_t) written;
+            }
+            else if ((errno != EINTR) && (errno != EAGAIN))
+            {
+                break;
+            }
+        }
+
+        pthread_mutex_lock(&stream_port_tx_mutex);
+        stream_port_tx_tail = tail + size;
+        stream_port_tx_busy = false;
+        pthread_cond_broadcast(&stream_port_tx_cond);
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: stream_port_set_fd
+********************************************************************************
+* Summary:
+*   Select the file descriptor used as the stream port on a host build. It
+*   must be opened in raw mode. Call it before stream_port_init().
+*
+* Parameters:
+*   fd: file descriptor of the port
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_port_set_fd(int fd)
+{
+    stream_port_fd = fd;
+}
+
+/*******************************************************************************
+* Function Name: stream_port_set_baud
+********************************************************************************
+* Summary:
+*   Throttle both directions of the port to the line rate of a UART, so the
+*   transfer times of a host build look like the ones of the device.
+*
+* Parameters:
+*   baud: line rate in bit/s, 0 to disable the throttling
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_port_set_baud(uint32_t baud)
+{
+    stream_port_baud = baud;
+}
+#else
+/*******************************************************************************
+* Function Name: stream_port_tx_drain
+********************************************************************************
+* Summary:
+*   Move bytes from the transmit queue to the UART transmit FIFO, until the
+*   FIFO is full or the queue is empty. The transmit interrupt is disabled
+*   once the queue is empty.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_port_tx_drain(void)
+{
+    uint32_t tail = stream_port_tx_tail;
+
+    while (tail != stream_port_tx_head)
+    {
+        uint32_t size = stream_port_tx_head - tail;
+        uint32_t put;
+
+        if (size > (STREAM_PORT_TX_QUEUE_SIZE - (tail & STREAM_PORT_TX_MASK)))
+        {
+            size = STREAM_PORT_TX_QUEUE_SIZE - (tail & STREAM_PORT_TX_MASK);
+        }
+        put = Cy_SCB_UART_PutArray(STREAM_PORT_UART_HW, &stream_port_tx_queue[tail & STREAM_PORT_TX_MASK], size);
+        tail += put;
+        if (put < size)
+        {
+            break;
+        }
+    }
+    stream_port_tx_tail = tail;
+
+    if (tail == stream_port_tx_head)
+    {
+        Cy_SCB_SetTxInterruptMask(STREAM_PORT_UART_HW, 0u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: stream_port_uart_isr
+********************************************************************************
+* Summary:
+*   Drain the UART receive FIFO and pass the bytes to the receive callback,
+*   then refill the transmit FIFO from the transmit queue.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_port_uart_isr(void)
+{
+    uint8_t  chunk[STREAM_PORT_RX_CHUNK_SIZE];
+    uint32_t size = 0;
+    uint32_t status = Cy_SCB_GetRxInterruptStatusMasked(STREAM_PORT_UART_HW);
+    uint32_t tx_status = Cy_SCB_GetTxInterruptStatusMasked(STREAM_PORT_UART_HW);
+
+    if (0u != (status & CY_SCB_RX_INTR_OVERFLOW))
+    {
+        stream_port_overflows++;
+    }
+
+    while (Cy_SCB_UART_GetNumInRxFifo(STREAM_PORT_UART_HW) > 0u)
+    {
+        chunk[size++] = (uint8_t) Cy_SCB_UART_Get(STREAM_PORT_UART_HW);
+        if (size == sizeof(chunk))
+        {
+            stream_port_rx_callback(chunk, size);
+            size = 0;
+        }
+    }
+
+    if (size > 0u)
+    {
+        stream_port_rx_callback(chunk, size);
+    }
+
+    Cy_SCB_ClearRxInterrupt(STREAM_PORT_UART_HW, status);
+
+    if (0u != (tx_status & CY_SCB_TX_INTR_LEVEL))
+    {
+        stream_port_tx_drain();
+        Cy_SCB_ClearTxInterrupt(STREAM_PORT_UART_HW, CY_SCB_TX_INTR_LEVEL);
+    }
+}
+#endif /* ML_PROFILER_HOST */
+
+/*******************************************************************************
+* Function Name: stream_port_init
+********************************************************************************
+* Summary:
+*   Start receiving on the stream port. On the device, the debug UART must be
+*   initialized already (app_retarget_io_init()); its receive interrupt is
+*   enabled, and its transmit interrupt is used to drain the transmit queue.
+*   On a host build, the reader and writer threads are started.
+*
+* Parameters:
+*   rx_callback: function called with the received bytes
+*
+* Return:
+*   cy_rslt_t: the status of the initialization.
+*******************************************************************************/
+cy_rslt_t stream_port_init(stream_port_rx_callback_t rx_callback)
+{
+    stream_port_rx_callback = rx_callback;
+
+#if defined(ML_PROFILER_HOST)
+    if (stream_port_fd < 0)
+    {
+        return STREAM_PORT_RESULT_ERROR;
+    }
+    if (!stream_port_reader_started)
+    {
+        if ((0 != pthread_create(&stream_port_reader, NULL, stream_port_reader_thread, NULL)) ||
+            (0 != pthread_create(&stream_port_writer, NULL, stream_port_writer_thread, NULL)))
+        {
+            return STREAM_PORT_RESULT_ERROR;
+        }
+        stream_port_reader_started = true;
+    }
+#else
+    const cy_stc_sysint_t uart_irq_cfg =
+    {
+        .intrSrc      = STREAM_PORT_UART_IRQ,
+        .intrPriority = STREAM_PORT_IRQ_PRIORITY,
+    };
+
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&uart_irq_cfg, stream_port_uart_isr))
+    {
+        return STREAM_PORT_RESULT_ERROR;
+    }
+
+    Cy_SCB_ClearRxInterrupt(STREAM_PORT_UART_HW, CY_SCB_RX_INTR_MASK);
+    Cy_SCB_SetRxInterruptMask(STREAM_PORT_UART_HW, CY_SCB_RX_INTR_NOT_EMPTY | CY_SCB_RX_INTR_OVERFLOW);
+
+    /* Refill the transmit FIFO when it is half empty. The interrupt is only
+     * enabled while the transmit queue holds bytes. */
+    Cy_SCB_SetTxFifoLevel(STREAM_PORT_UART_HW, Cy_SCB_GetFifoSize(STREAM_PORT_UART_HW) / 2u);
+    Cy_SCB_SetTxInterruptMask(STREAM_PORT_UART_HW, 0u);
+    Cy_SCB_ClearTxInterrupt(STREAM_PORT_UART_HW, CY_SCB_TX_INTR_MASK);
+    NVIC_EnableIRQ(STREAM_PORT_UART_IRQ);
+#endif /* ML_PROFILER_HOST */
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: stream_port_write
+********************************************************************************
+* Summary:
+*   Queue bytes for the stream port. It returns as soon as all the bytes are
+*   in the transmit queue; if the queue is full, it waits for it to drain.
+*
+* Parameters:
+*   data: pointer to the data
+*   size: number of bytes to write
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_port_write(const void *data, uint32_t size)
+{
+    const uint8_t *bytes = (const uint8_t *) data;
+    bool stalled = false;
+
+#if defined(ML_PROFILER_HOST)
+    pthread_mutex_lock(&stream_port_tx_mutex);
+#endif
+
+    while (size > 0u)
+    {
+        uint32_t head = stream_port_tx_head;
+        uint32_t used = head - stream_port_tx_tail;
+        uint32_t chunk = STREAM_PORT_TX_QUEUE_SIZE - used;
+
+        if (chunk == 0u)
+        {
+            /* Backpressure: wait for the queue to drain */
+            if (!stalled)
+            {
+                stream_port_tx_stalls++;
+                stalled = true;
+            }
+#if defined(ML_PROFILER_HOST)
+            pthread_cond_wait(&stream_port_tx_cond, &stream_port_tx_mutex);
+#endif
+            continue;
+        }
+
+        if (chunk > size)
+        {
+            chunk = size;
+        }
+        if (chunk > (STREAM_PORT_TX_QUEUE_SIZE - (head & STREAM_PORT_TX_MASK)))
+        {
+            chunk = STREAM_PORT_TX_QUEUE_SIZE - (head & STREAM_PORT_TX_MASK);
+        }
+        memcpy(&stream_port_tx_queue[head & STREAM_PORT_TX_MASK], bytes, chunk);
+        __atomic_store_n(&stream_port_tx_head, head + chunk, __ATOMIC_RELEASE);
+        bytes += chunk;
+        size -= chunk;
+
+        if ((used + chunk) > stream_port_tx_high_water)
+        {
+            stream_port_tx_high_water = used + chunk;
+        }
+
+        /* Start draining */
+#if defined(ML_PROFILER_HOST)
+        pthread_cond_broadcast(&stream_port_tx_cond);
+#else
+        Cy_SCB_SetTxInterruptMask(STREAM_PORT_UART_HW, CY_SCB_TX_INTR_LEVEL);
+#endif
+    }
+
+#if defined(ML_PROFILER_HOST)
+    pthread_mutex_unlock(&stream_port_tx_mutex);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: stream_port_flush
+********************************************************************************
+* Summary:
+*   Wait until every queued byte is out of the port. Call it before writing
+*   to the UART any other way, such as printf() on the device.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_port_flush(void)
+{
+#if defined(ML_PROFILER_HOST)
+    pthread_mutex_lock(&stream_port_tx_mutex);
+    while ((stream_port_tx_head != stream_port_tx_tail) || stream_port_tx_busy)
+    {
+        pthread_cond_wait(&stream_port_tx_cond, &stream_port_tx_mutex);
+    }
+    pthread_mutex_unlock(&stream_port_tx_mutex);
+#else
+    while (stream_port_tx_head != stream_port_tx_tail)
+    {
+    }
+    while (!Cy_SCB_UART_IsTxComplete(STREAM_PORT_UART_HW))
+    {
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: stream_port_get_time_ms
+********************************************************************************
+* Summary:
+*   Get a millisecond time base for the stream timeouts.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   uint32_t: time in milliseconds (wraps around)
+*******************************************************************************/
+uint32_t stream_port_get_time_ms(void)
+{
+#if defined(ML_PROFILER_HOST)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) (((uint64_t) ts.tv_sec * 1000u) + ((uint64_t) ts.tv_nsec / 1000000u));
+#else
+    uint64_t tick;
+
+    elapsed_timer_get_tick(&tick);
+    return (uint32_t) (tick / (elapsed_timer_get_frequency() / 1000u));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: stream_port_get_errors
+********************************************************************************
+* Summary:
+*   Get the error counters of the stream port.
+*
+* Parameters:
+*   overflows: returns the number of receive overflows
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_port_get_errors(uint32_t *overflows)
+{
+    *overflows = stream_port_overflows;
+}
+
+/*******************************************************************************
+* Function Name: stream_port_get_tx_stats
+********************************************************************************
+* Summary:
+*   Get the transmit queue statistics.
+*
+* Parameters:
+*   stats: returns the statistics
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_port_get_tx_stats(stream_port_tx_stats_t *stats)
+{
+    stats->size = STREAM_PORT_TX_QUEUE_SIZE;
+    stats->high_water = stream_port_tx_high_water;
+    stats->stalls = stream_port_tx_stalls;
+}
+
+/*******************************************************************************
+* Function Name: stream_port_reset_tx_stats
+********************************************************************************
+* Summary:
+*   Clear the transmit queue statistics.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_port_reset_tx_stats(void)
+{
+    stream_port_tx_high_water = 0;
+    stream_port_tx_stalls = 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,111 @@
+/******************************************************************************
+* File Name:   stream_port.h
+*
+* Description: This file contains the public interface of the byte transport
+*              used by the pipelined stream protocol.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef STREAM_PORT_H
+#define STREAM_PORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(ML_PROFILER_HOST)
+#include "host_compat.h"
+#else
+#include "cy_result.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+/* Priority of the UART interrupt receiving the stream */
+#ifndef STREAM_PORT_IRQ_PRIORITY
+#define STREAM_PORT_IRQ_PRIORITY    (3u)
+#endif
+
+/* Size of the transmit queue in bytes, a power of two. Writes return as soon
+ * as the bytes are queued, and only wait when the queue is full. */
+#ifndef STREAM_PORT_TX_QUEUE_SIZE
+#define STREAM_PORT_TX_QUEUE_SIZE   (2048u)
+#endif
+
+/* Error returned when the port cannot be opened */
+#define STREAM_PORT_RESULT_ERROR    ((cy_rslt_t) 0x00000001U)
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+/* Called for every chunk of received bytes. On the device, it is called from
+ * the UART interrupt; on a host build, from the reader thread. */
+typedef void (*stream_port_rx_callback_t)(const uint8_t *data, uint32_t size);
+
+/* Transmit queue statistics */
+typedef struct
+{
+    uint32_t size;       /* Size of the queue in bytes */
+    uint32_t high_water; /* Largest number of bytes queued */
+    uint32_t stalls;     /* Writes that waited for the queue to drain */
+} stream_port_tx_stats_t;
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+#if defined(ML_PROFILER_HOST)
+void      stream_port_set_fd(int fd);
+void      stream_port_set_baud(uint32_t baud);
+#endif
+cy_rslt_t stream_port_init(stream_port_rx_callback_t rx_callback);
+void      stream_port_write(const void *data, uint32_t size);
+void      stream_port_flush(void);
+uint32_t  stream_port_get_time_ms(void);
+void      stream_port_get_errors(uint32_t *overflows);
+void      stream_port_get_tx_stats(stream_port_tx_stats_t *stats);
+void      stream_port_reset_tx_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STREAM_PORT_H */
+
+/* [] END OF FILE */
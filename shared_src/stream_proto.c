@@ -0,0 +1,890 @@
+/******************************************************************************
+* File Name:   stream_proto.c
+*
+* Description: This file contains the implementation of the pipelined stream
+*              protocol. Frames are parsed as the bytes arrive (in the UART
+*              interrupt on the device) and the sample payloads are written
+*              straight into a ring of sample buffers. Every frame carries a
+*              CRC-32; a corrupted or lost frame is asked again with a NAK.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "stream_proto.h"
+#include "stream_port.h"
+
+#if defined(ML_PROFILER_HOST)
+#include <pthread.h>
+#include <sched.h>
+#else
+#include "cybsp.h"
+#endif
+
+#include <stddef.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* CRC-32 (IEEE 802.3, reflected), as zlib.crc32() on the host */
+#define STREAM_CRC_INIT         (0xFFFFFFFFu)
+
+/* Header bytes covered by the CRC, the CRC field is last */
+#define STREAM_HEADER_CRC_SIZE  (offsetof(stream_frame_header_t, crc))
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+/* Receive state machine */
+typedef enum
+{
+    STREAM_RX_HEADER,  /* Looking for the magic, then reading the header */
+    STREAM_RX_PAYLOAD, /* Reading the payload into its destination */
+    STREAM_RX_DISCARD, /* Skipping the payload of a rejected frame */
+} stream_rx_state_t;
+
+/* Sample buffer */
+typedef struct
+{
+    stream_proto_sample_t sample;
+    volatile uint32_t     ready; /* Set by the receiver, cleared by the application */
+} stream_proto_slot_t;
+
+/* Frame sent to the host, kept to send it again on a NAK */
+typedef struct
+{
+    const void *payload;
+    uint32_t    length;
+    uint16_t    seq;
+    uint8_t     type;   /* stream_frame_type_t, 0 if the entry is free */
+} stream_proto_sent_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* CRC-32 of the 16 values of a nibble */
+static const uint32_t stream_crc_table[16] =
+{
+    0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu, 0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+    0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu, 0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+};
+
+/* Receiver state, owned by the receive callback */
+static stream_rx_state_t     stream_rx_state;
+static stream_frame_header_t stream_rx_header;
+static uint32_t              stream_rx_count;
+static uint32_t              stream_rx_crc;
+static uint8_t              *stream_rx_dst;
+static uint32_t              stream_rx_slot_idx;
+static stream_nak_t          stream_rx_nak;
+
+/* Bytes accepted by the receive state machine, polled by the application to
+ * hold its NAK while a frame is still arriving */
+static volatile uint32_t     stream_rx_accepted;
+
+/* Sample buffers, each one holds the frame starting at a given seq */
+static stream_proto_slot_t stream_slots[STREAM_PROTO_RX_SLOTS];
+static uint8_t *stream_slot_pool;
+static uint32_t stream_slot_size;
+static uint32_t stream_slot_count;
+static uint32_t stream_slot_samples;
+
+/* Index of the next sample handed to the application */
+static uint32_t stream_app_slot_idx;
+
+/* Cumulative ack sent in the header of every frame. It is also the seq of
+ * the frame held in the next sample buffer of the application. */
+static uint16_t stream_tx_ack;
+
+/* Sample to ask again to the host, set by the receiver. A gap is only
+ * reported once per missing sample. */
+static volatile uint32_t stream_nak_pending;
+static uint16_t          stream_nak_seq;
+static uint16_t          stream_gap_seq;
+static bool              stream_gap_valid;
+
+/* Frame asked again by the host, type 0 if none */
+static volatile uint32_t stream_resend_type;
+static uint16_t          stream_resend_seq;
+
+/* Frames sent to the host */
+static stream_proto_sent_t stream_tx_history[STREAM_PROTO_TX_HISTORY];
+static uint32_t            stream_tx_history_idx;
+
+/* Last control frame received, type 0 if none is pending */
+static volatile uint32_t stream_control_type;
+static uint32_t stream_control_length;
+static uint8_t  stream_control_payload[STREAM_PROTO_MAX_CONTROL_SIZE];
+
+/* Receive statistics */
+static stream_proto_stats_t stream_stats;
+
+#if defined(ML_PROFILER_HOST)
+/* Serializes the reader thread and the application */
+static pthread_mutex_t stream_proto_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/*******************************************************************************
+* Function Name: stream_proto_lock
+********************************************************************************
+* Summary:
+*   Keep the receiver from running, while the application changes its state.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   uint32_t: state to pass to stream_proto_unlock()
+*******************************************************************************/
+static uint32_t stream_proto_lock(void)
+{
+#if defined(ML_PROFILER_HOST)
+    pthread_mutex_lock(&stream_proto_mutex);
+    return 0;
+#else
+    return Cy_SysLib_EnterCriticalSection();
+#endif
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_unlock
+********************************************************************************
+* Summary:
+*   Let the receiver run again.
+*
+* Parameters:
+*   state: value returned by stream_proto_lock()
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_proto_unlock(uint32_t state)
+{
+#if defined(ML_PROFILER_HOST)
+    (void) state;
+    pthread_mutex_unlock(&stream_proto_mutex);
+#else
+    Cy_SysLib_ExitCriticalSection(state);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_yield
+********************************************************************************
+* Summary:
+*   Give the receiver a chance to run while the application waits.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_proto_yield(void)
+{
+#if defined(ML_PROFILER_HOST)
+    sched_yield();
+#endif
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_timed_out
+********************************************************************************
+* Summary:
+*   Check if a timeout has expired.
+*
+* Parameters:
+*   start_ms: time when the wait started
+*   timeout_ms: timeout, or STREAM_PROTO_WAIT_FOREVER
+*
+* Return:
+*   bool: true if the timeout has expired
+*******************************************************************************/
+static bool stream_proto_timed_out(uint32_t start_ms, uint32_t timeout_ms)
+{
+    return (timeout_ms != STREAM_PROTO_WAIT_FOREVER) &&
+           ((stream_port_get_time_ms() - start_ms) >= timeout_ms);
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_crc32
+********************************************************************************
+* Summary:
+*   Update a CRC-32 with a block of bytes, a nibble at a time to keep the
+*   table small.
+*
+* Parameters:
+*   crc: current CRC, STREAM_CRC_INIT for the first block
+*   data: pointer to the bytes
+*   size: number of bytes
+*
+* Return:
+*   uint32_t: the updated CRC, to be inverted once the last block is added
+*******************************************************************************/
+static uint32_t stream_proto_crc32(uint32_t crc, const uint8_t *data, uint32_t size)
+{
+    while (size-- > 0u)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ stream_crc_table[crc & 0xFu];
+        crc = (crc >> 4) ^ stream_crc_table[crc & 0xFu];
+    }
+    return crc;
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_request_nak
+********************************************************************************
+* Summary:
+*   Ask the application to send a NAK for the first sample buffer of the
+*   window that is still missing. Called by the receiver after a corrupted
+*   frame, or when a frame arrives ahead of a missing one (a gap).
+*
+* Parameters:
+*   limit: number of buffers of the window to check
+*   gap: true if a gap was found, it is not reported twice
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_proto_request_nak(uint32_t limit, bool gap)
+{
+    for (uint32_t offset = 0; offset < limit; offset++)
+    {
+        uint32_t idx = (stream_app_slot_idx + offset) % stream_slot_count;
+
+        if (stream_slots[idx].ready == 0u)
+        {
+            uint16_t seq = (uint16_t) (stream_tx_ack + (offset * stream_slot_samples));
+
+            if (gap && stream_gap_valid && (stream_gap_seq == seq))
+            {
+                return;
+            }
+            if (gap)
+            {
+                stream_gap_seq = seq;
+                stream_gap_valid = true;
+            }
+            stream_nak_seq = seq;
+            __atomic_store_n(&stream_nak_pending, 1u, __ATOMIC_RELEASE);
+            return;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_start_payload
+********************************************************************************
+* Summary:
+*   Check a complete frame header and select where its payload goes. A SAMPLE
+*   frame goes to the buffer of its seq, so a frame sent again after a NAK
+*   fills the gap it left.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_proto_start_payload(void)
+{
+    stream_frame_header_t *header = &stream_rx_header;
+
+    stream_rx_count = 0;
+    stream_rx_dst = NULL;
+    stream_rx_crc = stream_proto_crc32(STREAM_CRC_INIT, (const uint8_t *) header, STREAM_HEADER_CRC_SIZE);
+
+    if (header->type == STREAM_FRAME_SAMPLE)
+    {
+        uint16_t distance = (uint16_t) (header->seq - stream_tx_ack);
+        uint32_t offset;
+
+        if ((stream_slot_pool == NULL) || (header->length > stream_slot_size))
+        {
+            stream_stats.bad_headers++;
+            stream_rx_state = STREAM_RX_HEADER;
+            return;
+        }
+
+        offset = distance / stream_slot_samples;
+        stream_rx_slot_idx = (stream_app_slot_idx + offset) % stream_slot_count;
+        if (((distance % stream_slot_samples) != 0u) || (offset >= stream_slot_count) ||
+            (stream_slots[stream_rx_slot_idx].ready != 0u))
+        {
+            /* Already received, or not in the window */
+            stream_stats.duplicates++;
+        }
+        else
+        {
+            stream_rx_dst = stream_slots[stream_rx_slot_idx].sample.data;
+        }
+    }
+    else if ((header->type == STREAM_FRAME_NAK) && (header->length == sizeof(stream_nak_t)))
+    {
+        stream_rx_dst = (uint8_t *) &stream_rx_nak;
+    }
+    else if ((header->type >= STREAM_FRAME_SESSION) && (header->type <= STREAM_FRAME_DONE) &&
+             (header->length <= STREAM_PROTO_MAX_CONTROL_SIZE))
+    {
+        if (stream_control_type == 0u)
+        {
+            stream_rx_dst = stream_control_payload;
+        }
+    }
+    else
+    {
+        stream_stats.bad_headers++;
+        stream_rx_state = STREAM_RX_HEADER;
+        return;
+    }
+
+    stream_rx_state = (stream_rx_dst != NULL) ? STREAM_RX_PAYLOAD : STREAM_RX_DISCARD;
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_end_frame
+********************************************************************************
+* Summary:
+*   Check the CRC of a complete frame and hand it over to the application. A
+*   corrupted frame is dropped and the first missing sample is asked again.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_proto_end_frame(void)
+{
+    stream_frame_header_t *header = &stream_rx_header;
+
+    if (stream_rx_state == STREAM_RX_PAYLOAD)
+    {
+        if ((stream_rx_crc ^ STREAM_CRC_INIT) != header->crc)
+        {
+            stream_stats.crc_errors++;
+            if (stream_slot_pool != NULL)
+            {
+                stream_proto_request_nak(stream_slot_count, false);
+            }
+        }
+        else if (header->type == STREAM_FRAME_SAMPLE)
+        {
+            stream_proto_slot_t *slot = &stream_slots[stream_rx_slot_idx];
+
+            stream_stats.frames++;
+            slot->sample.length = header->length;
+            slot->sample.seq = header->seq;
+            __atomic_store_n(&slot->ready, 1u, __ATOMIC_RELEASE);
+
+            /* A frame ahead of a missing one means that one was lost. The
+             * application may have released buffers since the header. */
+            stream_proto_request_nak((stream_rx_slot_idx + stream_slot_count - stream_app_slot_idx) %
+                                     stream_slot_count, true);
+        }
+        else if (header->type == STREAM_FRAME_NAK)
+        {
+            stream_stats.frames++;
+            stream_resend_seq = header->seq;
+            __atomic_store_n(&stream_resend_type, stream_rx_nak.type, __ATOMIC_RELEASE);
+        }
+        else
+        {
+            stream_stats.frames++;
+            stream_control_length = header->length;
+            __atomic_store_n(&stream_control_type, (uint32_t) header->type, __ATOMIC_RELEASE);
+        }
+    }
+
+    stream_rx_state = STREAM_RX_HEADER;
+    stream_rx_count = 0;
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_rx_bytes
+********************************************************************************
+* Summary:
+*   Parse received bytes. Use it as the receive callback of the stream port.
+*
+* Parameters:
+*   data: pointer to the received bytes
+*   size: number of bytes
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_proto_rx_bytes(const uint8_t *data, uint32_t size)
+{
+#if defined(ML_PROFILER_HOST)
+    uint32_t state = stream_proto_lock();
+#endif
+    uint8_t *header_bytes = (uint8_t *) &stream_rx_header;
+    uint32_t accepted = 0;
+
+    while (size > 0u)
+    {
+        if (stream_rx_state == STREAM_RX_HEADER)
+        {
+            uint8_t byte = *data++;
+            size--;
+
+            /* Hunt for the magic */
+            if (((stream_rx_count == 0u) && (byte != STREAM_PROTO_MAGIC0)) ||
+                ((stream_rx_count == 1u) && (byte != STREAM_PROTO_MAGIC1)))
+            {
+                stream_rx_count = (byte == STREAM_PROTO_MAGIC0) ? 1u : 0u;
+                continue;
+            }
+
+            header_bytes[stream_rx_count++] = byte;
+            accepted++;
+            if (stream_rx_count == sizeof(stream_frame_header_t))
+            {
+                stream_proto_start_payload();
+                if ((stream_rx_state != STREAM_RX_HEADER) && (stream_rx_header.length == 0u))
+                {
+                    stream_proto_end_frame();
+                }
+            }
+        }
+        else
+        {
+            uint32_t chunk = stream_rx_header.length - stream_rx_count;
+
+            if (chunk > size)
+            {
+                chunk = size;
+            }
+            if (stream_rx_state == STREAM_RX_PAYLOAD)
+            {
+                memcpy(&stream_rx_dst[stream_rx_count], data, chunk);
+                stream_rx_crc = stream_proto_crc32(stream_rx_crc, data, chunk);
+            }
+            stream_rx_count += chunk;
+            accepted += chunk;
+            data += chunk;
+            size -= chunk;
+
+            if (stream_rx_count == stream_rx_header.length)
+            {
+                stream_proto_end_frame();
+            }
+        }
+    }
+    __atomic_store_n(&stream_rx_accepted, stream_rx_accepted + accepted, __ATOMIC_RELEASE);
+
+#if defined(ML_PROFILER_HOST)
+    stream_proto_unlock(state);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_write_frame
+********************************************************************************
+* Summary:
+*   Write a frame to the port, with the current cumulative ack and its CRC.
+*
+* Parameters:
+*   type: frame type
+*   seq: sample index
+*   payload: pointer to the payload (can be NULL if length is 0)
+*   length: payload size in bytes
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_proto_write_frame(uint8_t type, uint16_t seq, const void *payload, uint32_t length)
+{
+    stream_frame_header_t header =
+    {
+        .magic    = { STREAM_PROTO_MAGIC0, STREAM_PROTO_MAGIC1 },
+        .type     = type,
+        .flags    = 0,
+        .seq      = seq,
+        .ack      = stream_tx_ack,
+        .length   = length,
+    };
+    uint32_t crc = stream_proto_crc32(STREAM_CRC_INIT, (const uint8_t *) &header, STREAM_HEADER_CRC_SIZE);
+
+    header.crc = stream_proto_crc32(crc, (const uint8_t *) payload, length) ^ STREAM_CRC_INIT;
+    stream_port_write(&header, sizeof(header));
+    if (length > 0u)
+    {
+        stream_port_write(payload, length);
+    }
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_send_nak
+********************************************************************************
+* Summary:
+*   Ask the host to send the SAMPLE frame starting at a given seq again.
+*
+* Parameters:
+*   seq: index of the first sample of the frame
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_proto_send_nak(uint16_t seq)
+{
+    stream_nak_t nak = { .type = STREAM_FRAME_SAMPLE };
+
+    stream_proto_write_frame(STREAM_FRAME_NAK, seq, &nak, sizeof(nak));
+    stream_stats.naks_sent++;
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_resend
+********************************************************************************
+* Summary:
+*   Send a frame of the history again.
+*
+* Parameters:
+*   type: frame type
+*   seq: sample index
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_proto_resend(uint32_t type, uint16_t seq)
+{
+    for (uint32_t i = 0; i < STREAM_PROTO_TX_HISTORY; i++)
+    {
+        stream_proto_sent_t *sent = &stream_tx_history[i];
+
+        if ((sent->type == type) && (sent->seq == seq))
+        {
+            stream_proto_write_frame(sent->type, sent->seq, sent->payload, sent->length);
+            stream_stats.resends++;
+            return;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_service
+********************************************************************************
+* Summary:
+*   Send the NAK asked by the receiver, and the frame asked again by the host.
+*   Called by the application while it waits, and before it sends a frame.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+static void stream_proto_service(void)
+{
+    if (__atomic_load_n(&stream_nak_pending, __ATOMIC_ACQUIRE) != 0u)
+    {
+        uint32_t state = stream_proto_lock();
+        uint16_t seq = stream_nak_seq;
+
+        stream_nak_pending = 0;
+        stream_proto_unlock(state);
+        stream_proto_send_nak(seq);
+    }
+
+    if (__atomic_load_n(&stream_resend_type, __ATOMIC_ACQUIRE) != 0u)
+    {
+        uint32_t type = stream_resend_type;
+        uint16_t seq = stream_resend_seq;
+
+        __atomic_store_n(&stream_resend_type, 0u, __ATOMIC_RELEASE);
+        stream_proto_resend(type, seq);
+    }
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_reset
+********************************************************************************
+* Summary:
+*   Drop any partial frame, pending control frame and received sample, and
+*   clear the statistics. Call it before waiting for a new session. The frames
+*   sent are kept, so the host can still ask for the DONE frame.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_proto_reset(void)
+{
+    uint32_t state = stream_proto_lock();
+
+    stream_rx_state = STREAM_RX_HEADER;
+    stream_rx_count = 0;
+    stream_rx_slot_idx = 0;
+    stream_app_slot_idx = 0;
+    stream_tx_ack = 0;
+    stream_control_type = 0;
+    stream_nak_pending = 0;
+    stream_gap_valid = false;
+    stream_resend_type = 0;
+    for (uint32_t i = 0; i < STREAM_PROTO_RX_SLOTS; i++)
+    {
+        stream_slots[i].ready = 0;
+    }
+    memset(&stream_stats, 0, sizeof(stream_stats));
+
+    stream_proto_unlock(state);
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_set_slots
+********************************************************************************
+* Summary:
+*   Set the memory of the sample buffers. Any received sample is dropped, and
+*   the frames sent in the previous session are forgotten.
+*
+* Parameters:
+*   pool: memory for slot_count buffers of slot_size bytes each
+*   slot_size: size of one sample buffer in bytes
+*   slot_count: number of buffers, up to STREAM_PROTO_RX_SLOTS
+*   samples_per_slot: samples per SAMPLE frame (the last one may hold fewer)
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_proto_set_slots(uint8_t *pool, uint32_t slot_size, uint32_t slot_count,
+                            uint32_t samples_per_slot)
+{
+    uint32_t state = stream_proto_lock();
+
+    stream_slot_pool = pool;
+    stream_slot_size = slot_size;
+    stream_slot_count = (slot_count < STREAM_PROTO_RX_SLOTS) ? slot_count : STREAM_PROTO_RX_SLOTS;
+    stream_slot_samples = (samples_per_slot != 0u) ? samples_per_slot : 1u;
+    stream_rx_slot_idx = 0;
+    stream_app_slot_idx = 0;
+    stream_gap_valid = false;
+    for (uint32_t i = 0; i < stream_slot_count; i++)
+    {
+        stream_slots[i].sample.data = &pool[i * slot_size];
+        stream_slots[i].ready = 0;
+    }
+    memset(stream_tx_history, 0, sizeof(stream_tx_history));
+    stream_tx_history_idx = 0;
+
+    stream_proto_unlock(state);
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_wait_control
+********************************************************************************
+* Summary:
+*   Wait for a control frame of the given type. Control frames of other types
+*   are dropped.
+*
+* Parameters:
+*   type: expected frame type
+*   payload: returns the payload, zero-padded up to size
+*   size: size of the payload buffer
+*   timeout_ms: timeout, or STREAM_PROTO_WAIT_FOREVER
+*
+* Return:
+*   bool: true if the frame was received
+*******************************************************************************/
+bool stream_proto_wait_control(stream_frame_type_t type, void *payload,
+                               uint32_t size, uint32_t timeout_ms)
+{
+    uint32_t start_ms = stream_port_get_time_ms();
+
+    for (;;)
+    {
+        uint32_t control_type = __atomic_load_n(&stream_control_type, __ATOMIC_ACQUIRE);
+
+        if (control_type == (uint32_t) type)
+        {
+            uint32_t length = (stream_control_length < size) ? stream_control_length : size;
+
+            memset(payload, 0, size);
+            memcpy(payload, stream_control_payload, length);
+            __atomic_store_n(&stream_control_type, 0u, __ATOMIC_RELEASE);
+            return true;
+        }
+        if (control_type != 0u)
+        {
+            __atomic_store_n(&stream_control_type, 0u, __ATOMIC_RELEASE);
+        }
+        if (stream_proto_timed_out(start_ms, timeout_ms))
+        {
+            return false;
+        }
+        stream_proto_service();
+        stream_proto_yield();
+    }
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_wait_sample
+********************************************************************************
+* Summary:
+*   Wait for the next sample. The sample buffer stays owned by the
+*   application until stream_proto_release_sample() is called. If no byte of
+*   the sample comes within STREAM_PROTO_NAK_TIMEOUT_MS, it is asked again;
+*   the timeout restarts on every byte received, so a frame longer than it
+*   on the line is not asked again while it arrives. A SESSION frame sent
+*   again by the host is answered with the INFO frame.
+*
+* Parameters:
+*   timeout_ms: timeout, or STREAM_PROTO_WAIT_FOREVER
+*
+* Return:
+*   stream_proto_sample_t *: the sample, NULL on timeout
+*******************************************************************************/
+stream_proto_sample_t *stream_proto_wait_sample(uint32_t timeout_ms)
+{
+    uint32_t start_ms = stream_port_get_time_ms();
+    uint32_t nak_ms = start_ms;
+    uint32_t rx_accepted = __atomic_load_n(&stream_rx_accepted, __ATOMIC_ACQUIRE);
+    uint32_t control_type;
+    stream_proto_slot_t *slot = &stream_slots[stream_app_slot_idx];
+
+    while (__atomic_load_n(&slot->ready, __ATOMIC_ACQUIRE) == 0u)
+    {
+        uint32_t accepted = __atomic_load_n(&stream_rx_accepted, __ATOMIC_ACQUIRE);
+
+        if (stream_proto_timed_out(start_ms, timeout_ms))
+        {
+            return NULL;
+        }
+        if (accepted != rx_accepted)
+        {
+            /* The frame is still arriving */
+            rx_accepted = accepted;
+            nak_ms = stream_port_get_time_ms();
+        }
+        else if (stream_proto_timed_out(nak_ms, STREAM_PROTO_NAK_TIMEOUT_MS))
+        {
+            stream_proto_send_nak(stream_tx_ack);
+            nak_ms = stream_port_get_time_ms();
+        }
+        control_type = __atomic_load_n(&stream_control_type, __ATOMIC_ACQUIRE);
+        if (control_type != 0u)
+        {
+            __atomic_store_n(&stream_control_type, 0u, __ATOMIC_RELEASE);
+            if (control_type == (uint32_t) STREAM_FRAME_SESSION)
+            {
+                stream_proto_resend(STREAM_FRAME_INFO, 0);
+            }
+        }
+        stream_proto_service();
+        stream_proto_yield();
+    }
+
+    return &slot->sample;
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_release_sample
+********************************************************************************
+* Summary:
+*   Give the buffer of the current sample back to the receiver. The ack is
+*   sent to the host in the next frame, so it can send one more SAMPLE frame.
+*
+* Parameters:
+*   ack: index of the first sample not consumed yet (cumulative ack)
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_proto_release_sample(uint16_t ack)
+{
+    /* The receiver places the frames relative to the ack */
+    uint32_t state = stream_proto_lock();
+
+    stream_slots[stream_app_slot_idx].ready = 0u;
+    stream_app_slot_idx = (stream_app_slot_idx + 1u) % stream_slot_count;
+    stream_tx_ack = ack;
+
+    stream_proto_unlock(state);
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_send
+********************************************************************************
+* Summary:
+*   Send a frame to the host. The frame is kept in the history, so the host
+*   can ask for it again: the payload must stay valid until
+*   STREAM_PROTO_TX_HISTORY more frames are sent, or the next session starts.
+*
+* Parameters:
+*   type: frame type
+*   seq: sample index
+*   payload: pointer to the payload (can be NULL if length is 0)
+*   length: payload size in bytes
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_proto_send(stream_frame_type_t type, uint16_t seq,
+                       const void *payload, uint32_t length)
+{
+    stream_proto_sent_t *sent = &stream_tx_history[stream_tx_history_idx];
+
+    stream_proto_service();
+
+    sent->type = (uint8_t) type;
+    sent->seq = seq;
+    sent->payload = payload;
+    sent->length = length;
+    stream_tx_history_idx = (stream_tx_history_idx + 1u) % STREAM_PROTO_TX_HISTORY;
+
+    stream_proto_write_frame((uint8_t) type, seq, payload, length);
+}
+
+/*******************************************************************************
+* Function Name: stream_proto_get_stats
+********************************************************************************
+* Summary:
+*   Get the receive statistics.
+*
+* Parameters:
+*   stats: returns the statistics
+*
+* Return:
+*   void
+*******************************************************************************/
+void stream_proto_get_stats(stream_proto_stats_t *stats)
+{
+    *stats = stream_stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,219 @@
+/******************************************************************************
+* File Name:   stream_proto.h
+*
+* Description: This file contains the public interface of the pipelined
+*              stream protocol.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef STREAM_PROTO_H
+#define STREAM_PROTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+/* Frame magic and protocol version. Keep in sync with tools/ml_stream_host.py */
+#define STREAM_PROTO_MAGIC0             ('M')
+#define STREAM_PROTO_MAGIC1             ('L')
+#define STREAM_PROTO_VERSION            (8u)
+
+/* Largest number of sample buffers, i.e. the largest window of SAMPLE frames
+ * the host may keep outstanding. While one frame is inferred, the next ones
+ * are received in the other buffers. */
+#ifndef STREAM_PROTO_RX_SLOTS
+#define STREAM_PROTO_RX_SLOTS           (8u)
+#endif
+
+/* Window used when the host does not ask for one */
+#ifndef STREAM_PROTO_DEFAULT_WINDOW
+#define STREAM_PROTO_DEFAULT_WINDOW     (2u)
+#endif
+
+/* Largest number of samples in a SAMPLE frame. Every sample buffer holds a
+ * full batch. */
+#ifndef STREAM_PROTO_MAX_BATCH
+#define STREAM_PROTO_MAX_BATCH          (8u)
+#endif
+
+/* Frames sent to the host kept for retransmission: the results of a full
+ * window, the INFO and the DONE frames */
+#define STREAM_PROTO_TX_HISTORY         (STREAM_PROTO_RX_SLOTS + 2u)
+
+/* Time without a byte of the next sample after which the device asks for it
+ * again */
+#ifndef STREAM_PROTO_NAK_TIMEOUT_MS
+#define STREAM_PROTO_NAK_TIMEOUT_MS     (100u)
+#endif
+
+/* Size of a top class in a compact reply: 16-bit index, 8-bit score */
+#define STREAM_PROTO_TOP_K_ENTRY_SIZE   (3u)
+
+/* Largest payload of a control frame */
+#define STREAM_PROTO_MAX_CONTROL_SIZE   (64u)
+
+/* Wait forever in stream_proto_wait_control() */
+#define STREAM_PROTO_WAIT_FOREVER       (0xFFFFFFFFu)
+
+/* Data type of the samples, reported in the INFO frame */
+#define STREAM_PROTO_DATA_INT8          (1u)
+#define STREAM_PROTO_DATA_INT16         (2u)
+#define STREAM_PROTO_DATA_FLOAT         (3u)
+
+/* Format of the samples sent by the host: in the data type of the model, or
+ * raw values the device quantizes into the input tensor */
+#define STREAM_PROTO_INPUT_MODEL        (0u)
+#define STREAM_PROTO_INPUT_UINT8        (1u)
+#define STREAM_PROTO_INPUT_FLOAT        (2u)
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+/* Frame types */
+typedef enum
+{
+    STREAM_FRAME_SESSION = 1, /* Host to device: start a session */
+    STREAM_FRAME_INFO    = 2, /* Device to host: session information */
+    STREAM_FRAME_SAMPLE  = 3, /* Host to device: batch of input samples */
+    STREAM_FRAME_RESULT  = 4, /* Device to host: model outputs (or top classes) of a batch */
+    STREAM_FRAME_DONE    = 5, /* Device to host: end of the session */
+    STREAM_FRAME_NAK     = 6, /* Either way: send the frame of type/seq again */
+} stream_frame_type_t;
+
+/* Frame header (16 bytes, little-endian), followed by the payload */
+typedef struct
+{
+    uint8_t  magic[2]; /* STREAM_PROTO_MAGIC0, STREAM_PROTO_MAGIC1 */
+    uint8_t  type;     /* stream_frame_type_t */
+    uint8_t  flags;    /* Reserved, 0 */
+    uint16_t seq;      /* Index of the first sample (SAMPLE, RESULT) */
+    uint16_t ack;      /* Device to host: cumulative ack, index of the first
+                        * sample whose buffer is not released yet */
+    uint32_t length;   /* Payload size in bytes */
+    uint32_t crc;      /* CRC-32 of the header bytes before it and the payload */
+} stream_frame_header_t;
+
+/* SESSION payload */
+typedef struct
+{
+    uint32_t num_samples;       /* Number of samples the host will send */
+    uint32_t recurrent_ts_size; /* Time steps per sample (RNN), 0 otherwise */
+    uint32_t batch_size;        /* Samples per SAMPLE frame wanted by the host */
+    uint32_t window;            /* Outstanding SAMPLE frames wanted by the host */
+    uint32_t codec;             /* Codec of the samples wanted by the host */
+    uint32_t reply_top_k;       /* Top classes per reply, 0 for the full outputs */
+    uint32_t input_format;      /* Format of the samples (STREAM_PROTO_INPUT_xxx) */
+    uint32_t rnn_stateful;      /* 1 to keep the RNN state across samples */
+} stream_session_t;
+
+/* INFO payload */
+typedef struct
+{
+    uint16_t version;          /* STREAM_PROTO_VERSION */
+    uint8_t  data_type;        /* STREAM_PROTO_DATA_xxx */
+    uint8_t  elem_size;        /* Size of one input/output element in bytes */
+    uint32_t sample_size;      /* Input elements per sample */
+    uint32_t output_size;      /* Output elements per sample */
+    uint32_t rx_slots;         /* Window: SAMPLE frames the host may keep unacked */
+    uint32_t batch_size;       /* Largest number of samples per SAMPLE frame */
+    uint32_t codec;            /* Codec of the samples (STREAM_CODEC_xxx) */
+    uint32_t reply_top_k;      /* Top classes per reply, 0 for the full outputs */
+    uint32_t input_format;     /* Format of the samples (STREAM_PROTO_INPUT_xxx) */
+    float    input_scale;      /* Scale of the input tensor */
+    int32_t  input_zero_point; /* Zero point of the input tensor */
+    uint32_t rnn_stateful;     /* 1 if the RNN state is kept across samples */
+} stream_info_t;
+
+/* NAK payload, the seq of the wanted frame is in the header */
+typedef struct
+{
+    uint32_t type; /* Type of the wanted frame */
+} stream_nak_t;
+
+/* DONE payload */
+typedef struct
+{
+    uint32_t status;      /* 0 on success, the error code otherwise */
+    uint32_t num_samples; /* Number of samples processed */
+} stream_done_t;
+
+/* Received batch of samples */
+typedef struct
+{
+    uint8_t  *data;   /* Payload of the SAMPLE frame */
+    uint32_t  length; /* Payload size in bytes */
+    uint16_t  seq;    /* Index of the first sample */
+} stream_proto_sample_t;
+
+/* Receive statistics */
+typedef struct
+{
+    uint32_t frames;        /* Frames received */
+    uint32_t bad_headers;   /* Headers rejected (unknown type, bad length) */
+    uint32_t crc_errors;    /* Frames dropped because of a CRC mismatch */
+    uint32_t duplicates;    /* SAMPLE frames received again, or out of the window */
+    uint32_t naks_sent;     /* Samples asked again to the host */
+    uint32_t resends;       /* Frames sent again on a NAK of the host */
+} stream_proto_stats_t;
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+void stream_proto_rx_bytes(const uint8_t *data, uint32_t size);
+void stream_proto_reset(void);
+void stream_proto_set_slots(uint8_t *pool, uint32_t slot_size, uint32_t slot_count,
+                            uint32_t samples_per_slot);
+bool stream_proto_wait_control(stream_frame_type_t type, void *payload,
+                               uint32_t size, uint32_t timeout_ms);
+stream_proto_sample_t *stream_proto_wait_sample(uint32_t timeout_ms);
+void stream_proto_release_sample(uint16_t ack);
+void stream_proto_send(stream_frame_type_t type, uint16_t seq,
+                       const void *payload, uint32_t length);
+void stream_proto_get_stats(stream_proto_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STREAM_PROTO_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,206 @@
+/******************************************************************************
+* File Name:   trace_buffer.c
+*
+* Description: This file contains the implementation of a binary trace
+*              buffer, recording profiling events with low overhead.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "trace_buffer.h"
+#include "elapsed_timer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(ML_PROFILER_HOST)
+#include "app_common.h"
+#endif
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+#if (TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1u)) != 0u
+#error "TRACE_BUFFER_SIZE must be a power of two"
+#endif
+
+#define TRACE_BUFFER_MASK   (TRACE_BUFFER_SIZE - 1u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Trace records */
+static trace_record_t trace_records[TRACE_BUFFER_SIZE];
+
+/* Number of events recorded since the last reset. Written by the producer
+ * only, after the record is complete. */
+static volatile uint32_t trace_head;
+
+/*******************************************************************************
+* Function Name: trace_buffer_write
+********************************************************************************
+* Summary:
+*   Write raw bytes to the debug UART (or stdout on a host build), bypassing
+*   the line ending conversion of retarget-io.
+*
+* Parameters:
+*   data: pointer to the data
+*   size: number of bytes to write
+*
+* Return:
+*   void
+*******************************************************************************/
+static void trace_buffer_write(const void *data, size_t size)
+{
+#if defined(ML_PROFILER_HOST)
+    fwrite(data, 1, size, stdout);
+#else
+    const uint8_t *ptr = (const uint8_t *) data;
+
+    while (size > 0)
+    {
+        size_t length = size;
+
+        if (CY_RSLT_SUCCESS != mtb_hal_uart_write(&mtb_ml_retarget_io_uart_obj, (void *) ptr, &length))
+        {
+            break;
+        }
+
+        ptr += length;
+        size -= length;
+    }
+#endif /* ML_PROFILER_HOST */
+}
+
+/*******************************************************************************
+* Function Name: trace_buffer_reset
+********************************************************************************
+* Summary:
+*   Discard all the recorded events.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void trace_buffer_reset(void)
+{
+    trace_head = 0;
+}
+
+/*******************************************************************************
+* Function Name: trace_buffer_record
+********************************************************************************
+* Summary:
+*   Record an event with the current tick. There must be a single producer;
+*   the record is published by incrementing the head index after it is
+*   written, so no lock is needed.
+*
+* Parameters:
+*   event_id: ID of the event
+*   arg: argument of the event
+*
+* Return:
+*   void
+*******************************************************************************/
+void trace_buffer_record(trace_event_id_t event_id, uint16_t arg)
+{
+    uint64_t tick;
+    uint32_t head = trace_head;
+    trace_record_t *record = &trace_records[head & TRACE_BUFFER_MASK];
+
+    elapsed_timer_get_tick(&tick);
+
+    record->timestamp = (uint32_t) tick;
+    record->event_id = (uint16_t) event_id;
+    record->arg = arg;
+
+    /* Publish the record */
+    __atomic_store_n(&trace_head, head + 1u, __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+* Function Name: trace_buffer_dump
+********************************************************************************
+* Summary:
+*   Send the recorded events in one burst: a trace_dump_header_t followed by
+*   the records, oldest first. Decode it with tools/trace_decode.py.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*******************************************************************************/
+void trace_buffer_dump(void)
+{
+    trace_dump_header_t header;
+    uint32_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+    uint32_t num_records = (head > TRACE_BUFFER_SIZE) ? TRACE_BUFFER_SIZE : head;
+    uint32_t first = head - num_records;
+
+    memcpy(header.magic, TRACE_BUFFER_MAGIC, sizeof(header.magic));
+    header.version = TRACE_BUFFER_VERSION;
+    header.record_size = sizeof(trace_record_t);
+    header.num_records = num_records;
+    header.num_events = head;
+    header.tick_hz = elapsed_timer_get_frequency();
+
+    printf("\r\nTrace dump: %lu records (%lu events)\r\n",
+           (unsigned long) num_records, (unsigned long) head);
+    fflush(stdout);
+
+    trace_buffer_write(&header, sizeof(header));
+
+    /* The records may wrap around the end of the buffer */
+    for (uint32_t i = first; i < head; )
+    {
+        uint32_t index = i & TRACE_BUFFER_MASK;
+        uint32_t count = TRACE_BUFFER_SIZE - index;
+
+        if (count > (head - i))
+        {
+            count = head - i;
+        }
+
+        trace_buffer_write(&trace_records[index], count * sizeof(trace_record_t));
+        i += count;
+    }
+
+    fflush(stdout);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,119 @@
+/******************************************************************************
+* File Name:   trace_buffer.h
+*
+* Description: This file contains the function prototypes and constants used
+*              in trace_buffer.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef TRACE_BUFFER_H
+#define TRACE_BUFFER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+/* Number of records in the trace buffer (must be a power of two). When the
+ * buffer is full, the oldest records are overwritten. */
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE       (1024u)
+#endif
+
+/* Magic number and version at the start of a trace dump */
+#define TRACE_BUFFER_MAGIC      "MLTR"
+#define TRACE_BUFFER_VERSION    (1u)
+
+/* Record an event. Compiled out if ML_TRACE is not defined. */
+#if defined(ML_TRACE)
+#define TRACE_EVENT(id, arg)    trace_buffer_record((id), (uint16_t) (arg))
+#else
+#define TRACE_EVENT(id, arg)
+#endif
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+/* Event IDs. Keep in sync with tools/trace_decode.py */
+typedef enum
+{
+    TRACE_EVENT_INFERENCE_START = 1,
+    TRACE_EVENT_INFERENCE_END   = 2,
+    TRACE_EVENT_OP_START        = 3,
+    TRACE_EVENT_OP_END          = 4,
+    TRACE_EVENT_STREAM_RX_START = 5,
+    TRACE_EVENT_STREAM_RX_END   = 6,
+    TRACE_EVENT_STREAM_TX_START = 7,
+    TRACE_EVENT_STREAM_TX_END   = 8,
+} trace_event_id_t;
+
+/* Trace record (8 bytes, little-endian in the dump) */
+typedef struct
+{
+    uint32_t timestamp; /* Lower 32 bits of the elapsed timer tick */
+    uint16_t event_id;  /* trace_event_id_t */
+    uint16_t arg;       /* Event argument (sample index, node index...) */
+} trace_record_t;
+
+/* Header of a trace dump, followed by the records (oldest first) */
+typedef struct
+{
+    char     magic[4];      /* TRACE_BUFFER_MAGIC */
+    uint16_t version;       /* TRACE_BUFFER_VERSION */
+    uint16_t record_size;   /* sizeof(trace_record_t) */
+    uint32_t num_records;   /* Number of records in the dump */
+    uint32_t num_events;    /* Number of events recorded, incl. overwritten */
+    uint32_t tick_hz;       /* Timestamp frequency, 0 if unknown */
+} trace_dump_header_t;
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+void trace_buffer_reset(void);
+void trace_buffer_record(trace_event_id_t event_id, uint16_t arg);
+void trace_buffer_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_BUFFER_H */
+
+/* [] END OF FILE */
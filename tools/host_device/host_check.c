@@ -0,0 +1,400 @@
+/******************************************************************************
+* File Name:   host_check.c
+*
+* Description: This is the source code of the host checks of the pure
+*              functions of shared_src, run by "make check". They feed
+*              synthetic inputs with a known answer and fail on a mismatch.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "elapsed_timer.h"
+#include "latency_histogram.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+/* Samples of the synthetic latency distributions */
+#define HISTOGRAM_CHECK_SAMPLES     (10000u)
+
+/* Reads of the synthetic cycle counter sequences */
+#define TIMER_CHECK_READS           (100000u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint32_t check_failures;
+static uint32_t check_random_state = 0x2545F491u;
+
+/*******************************************************************************
+* Function Name: check_random
+********************************************************************************
+* Summary:
+*   Return the next value of a xorshift generator, so the synthetic inputs are
+*   the same on every run.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   uint32_t: pseudo-random value
+*******************************************************************************/
+static uint32_t check_random(void)
+{
+    check_random_state ^= check_random_state << 13;
+    check_random_state ^= check_random_state >> 17;
+    check_random_state ^= check_random_state << 5;
+    return check_random_state;
+}
+
+/*******************************************************************************
+* Function Name: check_value
+********************************************************************************
+* Summary:
+*   Compare a value with the expected one, within a tolerance, and count a
+*   failure on a mismatch.
+*
+* Parameters:
+*   what: name of the checked value
+*   value: value to check
+*   expected: expected value
+*   tolerance: largest accepted difference
+*
+* Return:
+*   void
+*******************************************************************************/
+static void check_value(const char *what, uint64_t value, uint64_t expected, uint64_t tolerance)
+{
+    uint64_t diff = (value > expected) ? (value - expected) : (expected - value);
+
+    if (diff > tolerance)
+    {
+        printf("FAIL: %s=%" PRIu64 ", expected %" PRIu64 " +/- %" PRIu64 "\r\n",
+               what, value, expected, tolerance);
+        check_failures++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: check_bucket_tolerance
+********************************************************************************
+* Summary:
+*   Return the largest error of a percentile estimate near a value: the width
+*   of the histogram bucket holding the value, less one.
+*
+* Parameters:
+*   value: exact percentile
+*
+* Return:
+*   uint64_t: tolerance
+*******************************************************************************/
+static uint64_t check_bucket_tolerance(uint64_t value)
+{
+    uint32_t msb;
+
+    if (value < LATENCY_HISTOGRAM_SUB_BUCKETS)
+    {
+        return 0;
+    }
+    if (value > 0xFFFFFFFFu)
+    {
+        value = 0xFFFFFFFFu;
+    }
+
+    msb = 63u - (uint32_t) __builtin_clzll(value);
+    return (((uint64_t) 1u) << (msb - LATENCY_HISTOGRAM_SUB_BITS)) - 1u;
+}
+
+/*******************************************************************************
+* Function Name: compare_u64
+********************************************************************************
+* Summary:
+*   qsort() comparison of two uint64_t values.
+*
+* Parameters:
+*   a, b: values to compare
+*
+* Return:
+*   int: <0, 0 or >0
+*******************************************************************************/
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t va = *(const uint64_t *) a;
+    uint64_t vb = *(const uint64_t *) b;
+
+    return (va > vb) - (va < vb);
+}
+
+/*******************************************************************************
+* Function Name: check_histogram_percentiles
+********************************************************************************
+* Summary:
+*   Record the samples in a histogram and check its statistics against the
+*   sorted samples. The rank is computed like latency_histogram_percentile(),
+*   so the estimate stays in the bucket of the exact value.
+*
+* Parameters:
+*   hist: histogram to fill
+*   name: name of the distribution
+*   samples: latency samples, sorted in place
+*   count: number of samples
+*
+* Return:
+*   void
+*******************************************************************************/
+static void check_histogram_percentiles(latency_histogram_t *hist, const char *name,
+                                        uint64_t *samples, uint32_t count)
+{
+    static const float percentiles[] = { 50.0f, 90.0f, 99.0f, 99.9f };
+    uint64_t sum = 0;
+    char what[64];
+
+    latency_histogram_reset(hist);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        latency_histogram_record(hist, samples[i]);
+        sum += samples[i];
+    }
+    qsort(samples, count, sizeof(samples[0]), compare_u64);
+
+    snprintf(what, sizeof(what), "%s count", name);
+    check_value(what, hist->count, count, 0);
+    snprintf(what, sizeof(what), "%s min", name);
+    check_value(what, hist->min, samples[0], 0);
+    snprintf(what, sizeof(what), "%s max", name);
+    check_value(what, hist->max, samples[count - 1u], 0);
+    snprintf(what, sizeof(what), "%s sum", name);
+    check_value(what, hist->sum, sum, 0);
+
+    for (uint32_t i = 0; i < (sizeof(percentiles) / sizeof(percentiles[0])); i++)
+    {
+        /* Nearest rank */
+        uint32_t rank = (uint32_t) ((percentiles[i] * (float) count) / 100.0f + 0.999f);
+        uint64_t exact = samples[rank - 1u];
+
+        snprintf(what, sizeof(what), "%s p%g", name, (double) percentiles[i]);
+        check_value(what, latency_histogram_percentile(hist, percentiles[i]), exact,
+                    check_bucket_tolerance(exact));
+    }
+}
+
+/*******************************************************************************
+* Function Name: check_histogram
+********************************************************************************
+* Summary:
+*   Check the latency histogram with synthetic distributions: exact small
+*   values, a constant, a uniform and a bimodal distribution, and values
+*   above the 32-bit range of the buckets.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   void
+*******************************************************************************/
+static void check_histogram(void)
+{
+    static uint64_t samples[HISTOGRAM_CHECK_SAMPLES];
+    static latency_histogram_t hist;
+    uint32_t failures = check_failures;
+    uint64_t previous = 0;
+
+    /* Empty histogram */
+    latency_histogram_reset(&hist);
+    check_value("empty p50", latency_histogram_percentile(&hist, 50.0f), 0, 0);
+
+    /* Values below the number of sub-buckets have their own bucket */
+    for (uint32_t i = 0; i < LATENCY_HISTOGRAM_SUB_BUCKETS; i++)
+    {
+        latency_histogram_record(&hist, i);
+    }
+    check_value("small p0", latency_histogram_percentile(&hist, 0.0f), 0, 0);
+    check_value("small p100", latency_histogram_percentile(&hist, 100.0f),
+                LATENCY_HISTOGRAM_SUB_BUCKETS - 1u, 0);
+
+    /* The estimates are clamped to min/max, so a constant is exact */
+    latency_histogram_reset(&hist);
+    for (uint32_t i = 0; i < 100u; i++)
+    {
+        latency_histogram_record(&hist, 123457u);
+    }
+    check_value("constant p50", latency_histogram_percentile(&hist, 50.0f), 123457u, 0);
+    check_value("constant p99.9", latency_histogram_percentile(&hist, 99.9f), 123457u, 0);
+
+    /* Uniform 1 to N: the percentiles are monotonic and close to p * N */
+    for (uint32_t i = 0; i < HISTOGRAM_CHECK_SAMPLES; i++)
+    {
+        samples[i] = i + 1u;
+    }
+    check_histogram_percentiles(&hist, "uniform", samples, HISTOGRAM_CHECK_SAMPLES);
+    for (uint32_t p = 0; p <= 1000u; p++)
+    {
+        uint64_t value = latency_histogram_percentile(&hist, (float) p / 10.0f);
+
+        if (value < previous)
+        {
+            printf("FAIL: uniform percentiles decrease at p%g\r\n", (double) p / 10.0);
+            check_failures++;
+            break;
+        }
+        previous = value;
+    }
+
+    /* Uniform in random order, over a wide range */
+    for (uint32_t i = 0; i < HISTOGRAM_CHECK_SAMPLES; i++)
+    {
+        samples[i] = 1000u + (check_random() % 1000000u);
+    }
+    check_histogram_percentiles(&hist, "random", samples, HISTOGRAM_CHECK_SAMPLES);
+
+    /* Bimodal: 85% fast around 1000 cycles, 15% slow around 50000 cycles */
+    for (uint32_t i = 0; i < HISTOGRAM_CHECK_SAMPLES; i++)
+    {
+        samples[i] = ((check_random() % 100u) < 85u) ? (900u + (check_random() % 200u)) :
+                                                        (45000u + (check_random() % 10000u));
+    }
+    check_histogram_percentiles(&hist, "bimodal", samples, HISTOGRAM_CHECK_SAMPLES);
+
+    /* Values above 32 bits go to the last bucket, but keep their min/max/sum */
+    for (uint32_t i = 0; i < HISTOGRAM_CHECK_SAMPLES; i++)
+    {
+        samples[i] = (i < (HISTOGRAM_CHECK_SAMPLES / 2u)) ? 5000u : (0x100000000ull + i);
+    }
+    latency_histogram_reset(&hist);
+    for (uint32_t i = 0; i < HISTOGRAM_CHECK_SAMPLES; i++)
+    {
+        latency_histogram_record(&hist, samples[i]);
+    }
+    check_value("large p50", latency_histogram_percentile(&hist, 50.0f), 5000u,
+                check_bucket_tolerance(5000u));
+    check_value("large max", hist.max, 0x100000000ull + HISTOGRAM_CHECK_SAMPLES - 1u, 0);
+    check_value("large p99", latency_histogram_percentile(&hist, 99.0f), 0xFFFFFFFFull,
+                check_bucket_tolerance(0xFFFFFFFFull));
+
+    printf("Latency histogram: %s\r\n", (failures == check_failures) ? "ok" : "FAILED");
+}
+
+/*******************************************************************************
+* Function Name: check_timer_sequence
+********************************************************************************
+* Summary:
+*   Feed a synthetic 32-bit cycle counter to elapsed_timer_extend(), from a
+*   64-bit start value and with steps up to max_step (below 2^32, so a read
+*   happens at least once per wrap), and check every extended value.
+*
+* Parameters:
+*   name: name of the sequence
+*   start: 64-bit counter value of the first read
+*   max_step: largest number of cycles between two reads
+*   fixed_step: true to always step by max_step
+*
+* Return:
+*   void
+*******************************************************************************/
+static void check_timer_sequence(const char *name, uint64_t start, uint32_t max_step, bool fixed_step)
+{
+    /* State as set on the first read, the wraps before it are not counted */
+    elapsed_timer_ext_t ext = { .last = (uint32_t) start, .high = 0 };
+    uint64_t base = start & ~(uint64_t) 0xFFFFFFFFu;
+    uint64_t counter = start;
+    char what[64];
+
+    for (uint32_t i = 0; i < TIMER_CHECK_READS; i++)
+    {
+        uint64_t value = elapsed_timer_extend(&ext, (uint32_t) counter);
+
+        if (value != (counter - base))
+        {
+            snprintf(what, sizeof(what), "%s read %" PRIu32, name, i);
+            check_value(what, value, counter - base, 0);
+            return;
+        }
+
+        counter += fixed_step ? max_step : (check_random() % ((uint64_t) max_step + 1u));
+    }
+}
+
+/*******************************************************************************
+* Function Name: check_timer
+********************************************************************************
+* Summary:
+*   Check the 32-to-64-bit extension of the DWT cycle counter across wraps:
+*   starting just below a wrap, with steps that land exactly on 0, with equal
+*   reads, and with the largest step allowed between two reads.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   void
+*******************************************************************************/
+static void check_timer(void)
+{
+    uint32_t failures = check_failures;
+
+    check_timer_sequence("small steps", 0xFFFFFF00u, 16u, false);
+    check_timer_sequence("wrap to 0", 0x100000000ull - 0x10000000u, 0x10000000u, true);
+    check_timer_sequence("random steps", 0x3FFFFFFF0ull, 0xFFFFFFFFu, false);
+    check_timer_sequence("largest step", 0xFFFFFFFFu, 0xFFFFFFFFu, true);
+    check_timer_sequence("equal reads", 0x7FFFFFFFu, 0u, true);
+
+    printf("Timer wrap extension: %s\r\n", (failures == check_failures) ? "ok" : "FAILED");
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Run all the host checks.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   int: 0 if all the checks pass, 1 otherwise
+*******************************************************************************/
+int main(void)
+{
+    check_histogram();
+    check_timer();
+
+    return (check_failures == 0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
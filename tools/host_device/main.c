@@ -0,0 +1,255 @@
+/******************************************************************************
+* File Name:   main.c
+*
+* Description: This is the source code of the host stand-in of the ML
+*              profiler device. It runs the pipelined stream task of
+*              shared_src/ml_validation.c on a pty, socket or serial port.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "ml_validation.h"
+#include "elapsed_timer.h"
+#include "stack_usage.h"
+#include "stream_port.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <termios.h>
+#include <unistd.h>
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+/* Default size of the stand-in model (MNIST-like) */
+#define DEFAULT_INPUT_SIZE      (784)
+#define DEFAULT_OUTPUT_SIZE     (10)
+
+/* Stack of the thread running the profiler task, painted by stack_usage */
+#define HOST_TASK_STACK_SIZE    (256u * 1024u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint8_t host_task_stack[HOST_TASK_STACK_SIZE] __attribute__((aligned(4096)));
+
+/*******************************************************************************
+* Function Name: open_port
+********************************************************************************
+* Summary:
+*   Open the stream port in raw mode. With "--pty", a new pseudo-terminal is
+*   created and the path of its slave side is printed for the host program.
+*
+* Parameters:
+*   path: path of the port, or NULL to create a pty
+*
+* Return:
+*   int: file descriptor, -1 on error
+*******************************************************************************/
+static int open_port(const char *path)
+{
+    struct termios tio;
+    int fd;
+
+    if (path == NULL)
+    {
+        int slave_fd;
+
+        fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if ((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0))
+        {
+            return -1;
+        }
+
+        /* Keep the slave side open and raw, so the host program can come and go */
+        slave_fd = open(ptsname(fd), O_RDWR | O_NOCTTY);
+        if ((slave_fd < 0) || (tcgetattr(slave_fd, &tio) != 0))
+        {
+            return -1;
+        }
+        cfmakeraw(&tio);
+        tcsetattr(slave_fd, TCSANOW, &tio);
+
+        printf("Stream port: %s\r\n", ptsname(fd));
+        fflush(stdout);
+        return fd;
+    }
+
+    fd = open(path, O_RDWR | O_NOCTTY);
+    if ((fd >= 0) && isatty(fd) && (tcgetattr(fd, &tio) == 0))
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B1000000);
+        cfsetospeed(&tio, B1000000);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+/*******************************************************************************
+* Function Name: host_task
+********************************************************************************
+* Summary:
+*   Run the pipelined stream task for the requested number of sessions
+*   (forever if negative), on the thread stack registered with stack_usage.
+*
+* Parameters:
+*   arg: pointer to the number of sessions
+*
+* Return:
+*   void *: NULL
+*******************************************************************************/
+static void *host_task(void *arg)
+{
+    int sessions = *(int *) arg;
+
+    while (sessions != 0)
+    {
+        if (CY_RSLT_SUCCESS == ml_validation_pipeline_task())
+        {
+            printf("\n\rProfiling completed!\n\r");
+        }
+        else
+        {
+            printf("\n\rProfiling task failed!\n\r");
+        }
+
+        if (sessions > 0)
+        {
+            sessions--;
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Parse the command line, set up the stand-in model and run the pipelined
+*   stream task for the requested number of sessions (forever by default).
+*   The task runs on a thread whose stack is painted before it starts, so the
+*   report shows its peak depth like on the device.
+*
+* Parameters:
+*   argc: number of arguments
+*   argv: arguments
+*
+* Return:
+*   int: 0 on success
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *port_path = NULL;
+    mtb_ml_model_bin_t model_bin = { "HOST_MODEL", DEFAULT_INPUT_SIZE, DEFAULT_OUTPUT_SIZE };
+    int sessions = -1;
+    int baud = 0;
+    pthread_attr_t attr;
+    pthread_t thread;
+    int fd;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--port") == 0) && ((i + 1) < argc))
+        {
+            port_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--pty") == 0)
+        {
+            port_path = NULL;
+        }
+        else if ((strcmp(argv[i], "--input-size") == 0) && ((i + 1) < argc))
+        {
+            model_bin.input_size = atoi(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--output-size") == 0) && ((i + 1) < argc))
+        {
+            model_bin.output_size = atoi(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--sessions") == 0) && ((i + 1) < argc))
+        {
+            sessions = atoi(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--baud") == 0) && ((i + 1) < argc))
+        {
+            baud = atoi(argv[++i]);
+        }
+        else
+        {
+            printf("Usage: %s [--pty | --port PATH] [--input-size N] [--output-size N] [--sessions N] [--baud N]\r\n",
+                   argv[0]);
+            return 1;
+        }
+    }
+
+    /* Unbuffered, so the log is in order with the stream */
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    fd = open_port(port_path);
+    if (fd < 0)
+    {
+        printf("ERROR: cannot open the stream port\r\n");
+        return 1;
+    }
+    stream_port_set_fd(fd);
+    stream_port_set_baud((uint32_t) baud);
+
+    if ((CY_RSLT_SUCCESS != elapsed_timer_init()) ||
+        (CY_RSLT_SUCCESS != ml_validation_init(MTB_ML_PROFILE_ENABLE_MODEL, &model_bin)))
+    {
+        printf("ERROR: initialization failed\r\n");
+        return 1;
+    }
+
+    if ((!stack_usage_register("host_pipeline_task", host_task_stack,
+                               host_task_stack + HOST_TASK_STACK_SIZE)) ||
+        (pthread_attr_init(&attr) != 0) ||
+        (pthread_attr_setstack(&attr, host_task_stack, HOST_TASK_STACK_SIZE) != 0) ||
+        (pthread_create(&thread, &attr, host_task, &sessions) != 0))
+    {
+        printf("ERROR: cannot start the profiler task\r\n");
+        return 1;
+    }
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+
+    return 0;
+}
+
+/* [] END OF FILE */
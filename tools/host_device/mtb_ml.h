@@ -0,0 +1,170 @@
+/******************************************************************************
+* File Name:   mtb_ml.h
+*
+* Description: Stand-in for the ModusToolbox ML middleware API used by
+*              shared_src, to build the ML profiler natively on a host.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef MTB_ML_H
+#define MTB_ML_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "host_compat.h"
+
+/*******************************************************************************
+* Defines
+*******************************************************************************/
+#define MTB_ML_RESULT_SUCCESS               ((cy_rslt_t) 0x00000000U)
+#define MTB_ML_RESULT_BAD_ARG               ((cy_rslt_t) 0x00000001U)
+#define MTB_ML_RESULT_ALLOC_ERR             ((cy_rslt_t) 0x00000002U)
+#define MTB_ML_RESULT_BAD_MODEL             ((cy_rslt_t) 0x00000003U)
+#define MTB_ML_RESULT_MISMATCH_DATA_TYPE    ((cy_rslt_t) 0x00000004U)
+#define MTB_ML_RESULT_INFERENCE_ERROR       ((cy_rslt_t) 0x00000005U)
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+#if defined(COMPONENT_ML_FLOAT32)
+typedef float   MTB_ML_DATA_T;
+#elif defined(COMPONENT_ML_INT16x8)
+typedef int16_t MTB_ML_DATA_T;
+#else
+typedef int8_t  MTB_ML_DATA_T;
+#endif
+
+typedef enum
+{
+    MTB_ML_PROFILE_DISABLE,
+    MTB_ML_PROFILE_ENABLE_MODEL,
+    MTB_ML_LOG_ENABLE_MODEL_LOG,
+} mtb_ml_profile_config_t;
+
+/* Stand-in model: one dense layer with generated weights. With RNN_STREAMING,
+ * half of the previous output is added back, like a recurrent state. */
+typedef struct
+{
+    int            input_size;
+    int            output_size;
+    int            recurrent_ts_size;
+    MTB_ML_DATA_T *output;
+    MTB_ML_DATA_T *input;
+    int8_t        *weights;
+    MTB_ML_DATA_T *state;
+    uint8_t       *arena;
+    float          input_scale;
+    int            input_zero_point;
+    mtb_ml_profile_config_t profile_config;
+    uint64_t       profile_cycles;
+    uint64_t       profile_peak_cycles;
+    uint32_t       profile_runs;
+} mtb_ml_model_t;
+
+/* The variable tensor of the stand-in RNN, saved by the state checkpoints of
+ * the stateful stream */
+#define ML_RNN_STATE_BUFFER(model)  ((model)->state)
+#define ML_RNN_STATE_SIZE(model)    ((uint32_t) (model)->output_size * (uint32_t) sizeof(MTB_ML_DATA_T))
+
+/* Direct invoke of the stand-in model on the samples written in its input
+ * tensor, used by the validation tasks with ML_INPUT_IN_PLACE */
+#define ML_MODEL_INVOKE(model)      mtb_ml_host_model_invoke(model)
+#define ML_MODEL_INPUT_PTR(model)   mtb_ml_host_model_input_ptr()
+
+typedef struct
+{
+    const char *name;
+    int         input_size;
+    int         output_size;
+} mtb_ml_model_bin_t;
+
+typedef struct
+{
+    uint32_t data_type;
+    uint32_t num_of_samples;
+    uint32_t input_size;
+    int32_t  recurrent_ts_size;
+} mtb_ml_x_file_header_t;
+
+typedef struct
+{
+    int num_of_samples;
+    int recurrent_ts_size;
+} mtb_ml_x_data_info_t;
+
+typedef struct
+{
+    int dummy;
+} mtb_ml_stream_tag_t;
+
+typedef struct
+{
+    void                 *interface_obj;
+    mtb_ml_stream_tag_t  *stream_tag;
+    int                   input_size;
+    mtb_ml_x_data_info_t  x_data_info;
+} mtb_ml_stream_interface_t;
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_model_init(const mtb_ml_model_bin_t *bin, const void *buffer,
+                            mtb_ml_model_t **object);
+cy_rslt_t mtb_ml_model_profile_config(mtb_ml_model_t *object, mtb_ml_profile_config_t config);
+cy_rslt_t mtb_ml_model_profile_log(mtb_ml_model_t *object);
+cy_rslt_t mtb_ml_model_get_output(mtb_ml_model_t *object, MTB_ML_DATA_T **output, int *size);
+int       mtb_ml_model_get_input_size(mtb_ml_model_t *object);
+cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input);
+cy_rslt_t mtb_ml_model_rnn_reset_all_parameters(mtb_ml_model_t *object);
+void      mtb_ml_utils_print_model_info(mtb_ml_model_t *object);
+int       mtb_ml_utils_find_max(MTB_ML_DATA_T *input, int size);
+cy_rslt_t mtb_ml_stream_init(mtb_ml_stream_interface_t *iface, mtb_ml_model_t *object);
+cy_rslt_t mtb_ml_stream_input_data(mtb_ml_stream_interface_t *iface, MTB_ML_DATA_T *buffer,
+                                   uint32_t timeout_ms);
+cy_rslt_t mtb_ml_stream_output_data(mtb_ml_stream_interface_t *iface, MTB_ML_DATA_T *buffer,
+                                    uint32_t timeout_ms);
+cy_rslt_t mtb_ml_inform_host_done(mtb_ml_stream_interface_t *iface, uint32_t timeout_ms);
+
+/* Stand-ins of the invoke and input tensor functions of an interpreter-less
+ * model */
+cy_rslt_t      mtb_ml_host_model_invoke(mtb_ml_model_t *object);
+MTB_ML_DATA_T *mtb_ml_host_model_input_ptr(void);
+
+#endif /* MTB_ML_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,362 @@
+/******************************************************************************
+* File Name:   mtb_ml_host.c
+*
+* Description: Stand-in for the ModusToolbox ML middleware on a host. The
+*              model is a single dense layer with generated int8 weights, so
+*              the stream and profiling code can run without a device.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "mtb_ml.h"
+#include "elapsed_timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+/* Seed of the generated weights. Keep in sync with tools/ml_stream_host.py */
+#define MTB_ML_HOST_WEIGHT_SEED     (0x4D4C5046u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* The only model object */
+static mtb_ml_model_t mtb_ml_host_model;
+
+/*******************************************************************************
+* Function Name: mtb_ml_host_xorshift
+********************************************************************************
+* Summary:
+*   Generate the next pseudo-random number of the weight sequence.
+*
+* Parameters:
+*   state: generator state
+*
+* Return:
+*   uint32_t: next number
+*******************************************************************************/
+static uint32_t mtb_ml_host_xorshift(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/*******************************************************************************
+* Function Name: mtb_ml_host_shift
+********************************************************************************
+* Summary:
+*   Get the right shift that scales the dense layer accumulators back to the
+*   input range: ceil(log2(input_size)).
+*
+* Parameters:
+*   input_size: number of inputs
+*
+* Return:
+*   uint32_t: shift
+*******************************************************************************/
+static uint32_t mtb_ml_host_shift(int input_size)
+{
+    uint32_t shift = 0;
+
+    while ((1 << shift) < input_size)
+    {
+        shift++;
+    }
+    return shift;
+}
+
+/*******************************************************************************
+* Function Name: mtb_ml_host_invoke
+********************************************************************************
+* Summary:
+*   Run the stand-in model on the data in its input tensor.
+*
+* Parameters:
+*   object: the model object
+*
+* Return:
+*   void
+*******************************************************************************/
+static void mtb_ml_host_invoke(mtb_ml_model_t *object)
+{
+    uint32_t shift = mtb_ml_host_shift(object->input_size);
+
+    for (int o = 0; o < object->output_size; o++)
+    {
+        const int8_t *weights = &object->weights[(size_t) o * (size_t) object->input_size];
+#if defined(COMPONENT_ML_FLOAT32)
+        float acc = 0.0f;
+
+        for (int i = 0; i < object->input_size; i++)
+        {
+            acc += (float) weights[i] * object->input[i];
+        }
+        object->output[o] = acc / (float) (1u << shift);
+#if defined(RNN_STREAMING)
+        object->output[o] += 0.5f * object->state[o];
+#endif
+#else
+        int64_t acc = 0;
+
+        for (int i = 0; i < object->input_size; i++)
+        {
+            acc += (int32_t) weights[i] * (int32_t) object->input[i];
+        }
+        acc >>= shift;
+#if defined(RNN_STREAMING)
+        acc += object->state[o] >> 1;
+#endif
+#if defined(COMPONENT_ML_INT16x8)
+        object->output[o] = (MTB_ML_DATA_T) ((acc > INT16_MAX) ? INT16_MAX : ((acc < INT16_MIN) ? INT16_MIN : acc));
+#else
+        object->output[o] = (MTB_ML_DATA_T) ((acc > INT8_MAX) ? INT8_MAX : ((acc < INT8_MIN) ? INT8_MIN : acc));
+#endif
+#endif /* COMPONENT_ML_FLOAT32 */
+    }
+
+#if defined(RNN_STREAMING)
+    memcpy(object->state, object->output, (size_t) object->output_size * sizeof(MTB_ML_DATA_T));
+#endif
+
+    /* Like the TFLM memory planner, reuse the input tensor once it is consumed */
+    memset(object->input, 0x5A, (size_t) object->input_size * sizeof(MTB_ML_DATA_T));
+}
+
+/*******************************************************************************
+* ML middleware API stand-ins. See the middleware documentation for details.
+*******************************************************************************/
+cy_rslt_t mtb_ml_model_init(const mtb_ml_model_bin_t *bin, const void *buffer,
+                            mtb_ml_model_t **object)
+{
+    mtb_ml_model_t *model = &mtb_ml_host_model;
+    size_t weights_size;
+    size_t arena_size;
+    uint32_t state = MTB_ML_HOST_WEIGHT_SEED;
+
+    (void) buffer;
+
+    if ((bin == NULL) || (bin->input_size <= 0) || (bin->output_size <= 0) || (object == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    /* Like the TFLM interpreter, allocate the tensor arena from the heap */
+    weights_size = (size_t) bin->input_size * (size_t) bin->output_size;
+    arena_size = weights_size + (((size_t) bin->input_size + (2u * (size_t) bin->output_size)) * sizeof(MTB_ML_DATA_T));
+    memset(model, 0, sizeof(*model));
+    model->arena = (uint8_t *) malloc(arena_size);
+    if (model->arena == NULL)
+    {
+        return MTB_ML_RESULT_ALLOC_ERR;
+    }
+
+    model->input_size = bin->input_size;
+    model->output_size = bin->output_size;
+    model->input = (MTB_ML_DATA_T *) model->arena;
+    model->output = model->input + bin->input_size;
+    model->state = model->output + bin->output_size;
+    model->weights = (int8_t *) (model->state + bin->output_size);
+    memset(model->state, 0, (size_t) bin->output_size * sizeof(MTB_ML_DATA_T));
+
+    /* Input quantization of the MNIST regression data: the int8 inputs are
+     * the pixels minus 128, the int16 inputs map 0..255 to 0..32767 */
+#if defined(COMPONENT_ML_INT16x8)
+    model->input_scale = 255.0f / 32767.0f;
+    model->input_zero_point = 0;
+#elif defined(COMPONENT_ML_FLOAT32)
+    model->input_scale = 1.0f;
+    model->input_zero_point = 0;
+#else
+    model->input_scale = 1.0f;
+    model->input_zero_point = -128;
+#endif
+
+    for (size_t i = 0; i < weights_size; i++)
+    {
+        model->weights[i] = (int8_t) (mtb_ml_host_xorshift(&state) >> 24);
+    }
+
+    *object = model;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_profile_config(mtb_ml_model_t *object, mtb_ml_profile_config_t config)
+{
+    object->profile_config = config;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_profile_log(mtb_ml_model_t *object)
+{
+    if ((object->profile_config != MTB_ML_PROFILE_DISABLE) && (object->profile_runs > 0u))
+    {
+        printf("\r\nPROFILE_INFO, host model, avg cycles=%" PRIu64 ", peak cycles=%" PRIu64 ", runs=%" PRIu32 "\r\n",
+               object->profile_cycles / object->profile_runs, object->profile_peak_cycles,
+               object->profile_runs);
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_get_output(mtb_ml_model_t *object, MTB_ML_DATA_T **output, int *size)
+{
+    *output = object->output;
+    *size = object->output_size;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+int mtb_ml_model_get_input_size(mtb_ml_model_t *object)
+{
+    return object->input_size;
+}
+
+cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input)
+{
+    uint64_t start_tick;
+    uint64_t end_tick;
+
+    /* The middleware would copy an input already in the input tensor onto
+     * itself: such an input must be run with mtb_ml_host_model_invoke() */
+    if (input == object->input)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    elapsed_timer_get_tick(&start_tick);
+
+    /* Like the middleware, copy the input into the input tensor */
+    memcpy(object->input, input, (size_t) object->input_size * sizeof(MTB_ML_DATA_T));
+    mtb_ml_host_invoke(object);
+
+    elapsed_timer_get_tick(&end_tick);
+
+    if (object->profile_config != MTB_ML_PROFILE_DISABLE)
+    {
+        uint64_t cycles = end_tick - start_tick;
+
+        object->profile_cycles += cycles;
+        object->profile_runs++;
+        if (cycles > object->profile_peak_cycles)
+        {
+            object->profile_peak_cycles = cycles;
+        }
+    }
+
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_rnn_reset_all_parameters(mtb_ml_model_t *object)
+{
+    memset(object->state, 0, (size_t) object->output_size * sizeof(MTB_ML_DATA_T));
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+void mtb_ml_utils_print_model_info(mtb_ml_model_t *object)
+{
+    printf("Host model: dense %d -> %d, %u-byte elements\r\n",
+           object->input_size, object->output_size, (unsigned) sizeof(MTB_ML_DATA_T));
+}
+
+int mtb_ml_utils_find_max(MTB_ML_DATA_T *input, int size)
+{
+    int max_idx = 0;
+
+    for (int i = 1; i < size; i++)
+    {
+        if (input[i] > input[max_idx])
+        {
+            max_idx = i;
+        }
+    }
+    return max_idx;
+}
+
+/* The ML Configurator stream protocol is not available on a host */
+cy_rslt_t mtb_ml_stream_init(mtb_ml_stream_interface_t *iface, mtb_ml_model_t *object)
+{
+    (void) iface;
+    (void) object;
+    return MTB_ML_RESULT_BAD_ARG;
+}
+
+cy_rslt_t mtb_ml_stream_input_data(mtb_ml_stream_interface_t *iface, MTB_ML_DATA_T *buffer,
+                                   uint32_t timeout_ms)
+{
+    (void) iface;
+    (void) buffer;
+    (void) timeout_ms;
+    return MTB_ML_RESULT_BAD_ARG;
+}
+
+cy_rslt_t mtb_ml_stream_output_data(mtb_ml_stream_interface_t *iface, MTB_ML_DATA_T *buffer,
+                                    uint32_t timeout_ms)
+{
+    (void) iface;
+    (void) buffer;
+    (void) timeout_ms;
+    return MTB_ML_RESULT_BAD_ARG;
+}
+
+cy_rslt_t mtb_ml_inform_host_done(mtb_ml_stream_interface_t *iface, uint32_t timeout_ms)
+{
+    (void) iface;
+    (void) timeout_ms;
+    return MTB_ML_RESULT_BAD_ARG;
+}
+
+/* Like the invoke function of an interpreter-less model, run the data already
+ * in the input tensor, without the input copy and the profiling of
+ * mtb_ml_model_run() */
+cy_rslt_t mtb_ml_host_model_invoke(mtb_ml_model_t *object)
+{
+    mtb_ml_host_invoke(object);
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+MTB_ML_DATA_T *mtb_ml_host_model_input_ptr(void)
+{
+    return mtb_ml_host_model.input;
+}
+
+/* [] END OF FILE */
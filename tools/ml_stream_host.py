@@ -0,0 +1,791 @@
+#!/usr/bin/env python3
+################################################################################
+# \file ml_stream_host.py
+# \version 1.0
+#
+# \brief
+# Host side of the pipelined stream protocol (shared_src/stream_proto.h). It
+# streams regression samples to the ML profiler built with
+# ML_VALIDATION_SOURCE=pipeline, keeps a window of frames outstanding (freed
+# by the cumulative ack of the device), and prints the results and the device
+# log. Each frame carries a batch of samples, optionally compressed
+# (--codec). The device can reply with the top classes of each sample instead
+# of the full outputs (--top-k). Every frame carries a CRC-32; corrupted or
+# lost frames are asked again with a NAK, by either side. --sweep-batch and --sweep-window measure the
+# throughput for several batch sizes or windows.
+#
+# The samples come from regression files (x data .bin, or the .c generated by
+# the ML Configurator) or from a sample_data CSV (label, then the inputs). They
+# can also be sent as raw uint8 or float values (--input-format) that the
+# device quantizes into the input tensor, so the float x data or one CSV serves
+# every NN_TYPE. For RNN models (NN_RNN_MODEL=yes), --rnn-stride streams the
+# time steps a few at a time while the device keeps its state, instead of
+# replaying a full sequence per sample. The top-1 and top-5 accuracy are
+# computed against the y data (--y-bin) or the CSV labels, and
+# --min-accuracy/--min-rate turn the run into a pass/fail check (on the top-1
+# accuracy). --spawn starts the native build of the device (tools/host_device)
+# on a pty, for CI; --max-stack then checks the stack peak in its report, and
+# --check-in-place checks that the samples were run from the input tensor.
+# --check-clean-link fails on any NAK or frame sent again, for a line without
+# errors.
+#
+# Usage:
+#   python3 ml_stream_host.py /dev/ttyACM0 --x-bin x_data.bin --y-bin y_data.bin
+#   python3 ml_stream_host.py /dev/ttyACM0 --csv mnist_test_data.csv
+#   python3 ml_stream_host.py --spawn host_device/build/ml_profiler_host --random 1000 --min-rate 1000
+#   python3 ml_stream_host.py /dev/pts/3 --random 1000 --batch 4
+#   python3 ml_stream_host.py /dev/pts/3 --random 1000 --sweep-batch 1,2,4,8
+#   python3 ml_stream_host.py /dev/pts/3 --random 1000 --sweep-window 1,2,4,8
+#   python3 ml_stream_host.py /dev/ttyACM0 --x-bin x_data.bin --codec delta-zrle
+#   python3 ml_stream_host.py /dev/ttyACM0 --x-bin x_data_float.bin --input-format uint8
+#   python3 ml_stream_host.py /dev/ttyACM0 --x-bin x_data.bin --rnn-stride 1 --check-replay 8
+#
+# The port can be a serial port or the pty printed by the host stand-in of the
+# device (tools/host_device).
+#
+################################################################################
+# \copyright
+# Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import datetime
+import os
+import queue
+import random
+import re
+import select
+import struct
+import subprocess
+import sys
+import termios
+import threading
+import time
+import tty
+import zlib
+
+# Keep in sync with shared_src/stream_proto.h
+MAGIC = b"ML"
+VERSION = 8
+HEADER_FORMAT = "<2sBBHHII"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+HEADER_CRC_SIZE = HEADER_SIZE - 4
+MAX_CONTROL_SIZE = 64
+
+FRAME_SESSION = 1
+FRAME_INFO = 2
+FRAME_SAMPLE = 3
+FRAME_RESULT = 4
+FRAME_DONE = 5
+FRAME_NAK = 6
+
+# Time without a frame from the device after which a missing one is asked again
+RETRANSMIT_TIMEOUT = 0.5
+
+SESSION_FORMAT = "<IIIIIIII"
+INFO_FORMAT = "<HBBIIIIIIIfiI"
+TOP_K_ENTRY_FORMAT = "<HB"
+TOP_K_ENTRY_SIZE = struct.calcsize(TOP_K_ENTRY_FORMAT)
+# Classes ranked for the top-5 accuracy
+TOP_N_ACCURACY = 5
+NAK_FORMAT = "<I"
+DONE_FORMAT = "<II"
+X_HEADER_FORMAT = "<IIIi"
+
+DATA_TYPES = {1: ("int8", "b"), 2: ("int16", "h"), 3: ("float", "f")}
+
+# Format of the samples: in the data type of the model, or raw values the
+# device quantizes, with their struct format
+INPUT_FORMATS = {"model": (0, None), "uint8": (1, "B"), "float": (2, "f")}
+
+# Data type field of the x data header
+X_DATA_TYPES = {1: "f", 2: "b", 3: "h"}
+
+# Keep in sync with shared_src/stream_codec.h
+CODECS = {"none": 0, "zrle": 1, "delta-zrle": 2}
+RUN_TOKEN = 0x80
+MAX_TOKEN_RUN = 128
+
+
+def zrle_encode(data):
+    """Zero-run length encoding: a token below 0x80 is followed by token + 1
+    literal bytes, a token from 0x80 stands for token - 0x7F zero bytes."""
+    out = bytearray()
+    literal_start = 0
+    i = 0
+    n = len(data)
+
+    def flush_literals(end):
+        for start in range(literal_start, end, MAX_TOKEN_RUN):
+            chunk = data[start:min(start + MAX_TOKEN_RUN, end)]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+
+    while i < n:
+        if data[i] == 0:
+            run_end = i
+            while run_end < n and data[run_end] == 0:
+                run_end += 1
+            # A single zero is cheaper as a literal, unless it ends the data
+            if run_end - i >= 2 or run_end == n:
+                flush_literals(i)
+                while i < run_end:
+                    length = min(run_end - i, MAX_TOKEN_RUN)
+                    out.append(RUN_TOKEN + length - 1)
+                    i += length
+                literal_start = i
+                continue
+            i = run_end
+        else:
+            i += 1
+    flush_literals(n)
+    return bytes(out)
+
+
+def delta_encode(data):
+    """Replace every byte by its difference to the previous one (modulo 256)."""
+    prev = 0
+    out = bytearray(len(data))
+    for i, byte in enumerate(data):
+        out[i] = (byte - prev) & 0xFF
+        prev = byte
+    return bytes(out)
+
+
+def encode_sample(codec, sample):
+    if codec == CODECS["zrle"]:
+        return zrle_encode(sample)
+    if codec == CODECS["delta-zrle"]:
+        return zrle_encode(delta_encode(sample))
+    return sample
+
+
+class StreamLink:
+    """Frames over a raw serial port or pty. Bytes outside of frames are the
+    device log, they are copied to stdout. Frames with a bad CRC are counted
+    and dropped."""
+
+    def __init__(self, path, baud):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        if os.isatty(self.fd):
+            tty.setraw(self.fd)
+            attrs = termios.tcgetattr(self.fd)
+            speed = getattr(termios, "B%d" % baud, None)
+            if speed is not None:
+                attrs[4] = attrs[5] = speed
+                termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+        self.rx = bytearray()
+        self.max_payload = MAX_CONTROL_SIZE
+        self.crc_errors = 0
+
+    def send(self, frame_type, seq, payload=b""):
+        header = struct.pack(HEADER_FORMAT, MAGIC, frame_type, 0, seq & 0xFFFF, 0,
+                             len(payload), 0)[:HEADER_CRC_SIZE]
+        data = header + struct.pack("<I", zlib.crc32(header + payload)) + payload
+        view = memoryview(data)
+        while view:
+            written = os.write(self.fd, view)
+            view = view[written:]
+
+    def _flush_text(self, end):
+        if end > 0:
+            sys.stdout.write(self.rx[:end].decode("utf-8", "replace"))
+            sys.stdout.flush()
+            del self.rx[:end]
+
+    def receive(self, timeout):
+        """Return the next frame as (type, seq, ack, payload), None on timeout."""
+        deadline = time.monotonic() + timeout
+        while True:
+            start = self.rx.find(MAGIC)
+            if start < 0:
+                # Keep a trailing "M", it may start the next magic
+                self._flush_text(len(self.rx) - (1 if self.rx.endswith(MAGIC[:1]) else 0))
+            else:
+                self._flush_text(start)
+                if len(self.rx) >= HEADER_SIZE:
+                    _, frame_type, _, seq, ack, length, crc = struct.unpack_from(HEADER_FORMAT, self.rx)
+                    if not (FRAME_SESSION <= frame_type <= FRAME_NAK) or length > self.max_payload:
+                        # Not a frame, just text that looks like the magic
+                        self._flush_text(1)
+                        continue
+                    if len(self.rx) >= HEADER_SIZE + length:
+                        payload = bytes(self.rx[HEADER_SIZE:HEADER_SIZE + length])
+                        if zlib.crc32(bytes(self.rx[:HEADER_CRC_SIZE]) + payload) != crc:
+                            # Corrupted: drop it, up to the next frame inside
+                            # it in case the length was corrupted
+                            self.crc_errors += 1
+                            end = self.rx.find(MAGIC, 1, HEADER_SIZE + length)
+                            del self.rx[:end if end > 0 else HEADER_SIZE + length]
+                            continue
+                        del self.rx[:HEADER_SIZE + length]
+                        return frame_type, seq, ack, payload
+
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                return None
+            ready, _, _ = select.select([self.fd], [], [], remaining)
+            if ready:
+                try:
+                    self.rx += os.read(self.fd, 65536)
+                except OSError:
+                    time.sleep(0.01)
+
+
+def load_regression_file(path):
+    """Return the bytes of a regression file: a .bin file, or the array of the
+    .c file generated by the ML Configurator."""
+    if not path.endswith(".c"):
+        with open(path, "rb") as f:
+            return f.read()
+    with open(path) as f:
+        text = f.read()
+    body = text[text.index("= {"):]
+    return bytes(int(h, 16) for h in re.findall(r"0x([0-9a-fA-F]{2})", body))
+
+
+def write_regression_c_files(out_dir, base, array, data, tool, source, contents):
+    """Write the .c and .h files of a byte array generated by a tool from a
+    regression file, in the layout of the regression files of the ML
+    Configurator. contents ends the "this file contains" sentence of the
+    banner. Return the path of the .c file."""
+    guard = base.upper() + "_H"
+    date = datetime.datetime.now()
+    banner = ("/***************************************************************************//**\n"
+              "* \\file %s\n"
+              "*\n"
+              "* \\brief\n"
+              "* Generated with tools/%s from %s, this file contains\n"
+              "* %s.\n"
+              "* Date: %s\n"
+              "*******************************************************************************\n"
+              "* \\copyright\n"
+              "* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company).\n"
+              "* All rights reserved.\n"
+              "* You may use this file only in accordance with the license, terms, conditions,\n"
+              "* disclaimers, and limitations in the end user license agreement accompanying\n"
+              "* the software package with which this file was provided.\n"
+              "******************************************************************************/\n"
+              "\n\n")
+
+    with open(os.path.join(out_dir, base + ".h"), "w") as f:
+        f.write(banner % (base + ".h", tool, source, contents, date))
+        f.write("#ifndef %s\n#define %s\n\n#include <stdint.h>\n\n\n" % (guard, guard))
+        f.write("extern const uint8_t %s[];\n" % array)
+        f.write("#define %s_LEN (%d)\n\n" % (array.upper(), len(data)))
+        f.write("#endif // %s\n" % guard)
+
+    with open(os.path.join(out_dir, base + ".c"), "w") as f:
+        f.write(banner % (base + ".c", tool, source, contents, date))
+        f.write("#include \"%s.h\"\n\n\n" % base)
+        f.write("const uint8_t %s[%s_LEN] __attribute__((aligned(4))) = {\n" % (array, array.upper()))
+        for i in range(0, len(data), 12):
+            f.write("  " + ", ".join("0x%02x" % b for b in data[i:i + 12]) +
+                    ("," if i + 12 < len(data) else "") + "\n")
+        f.write("};\n")
+    return os.path.join(out_dir, base + ".c")
+
+
+def pack_raw(values, input_format):
+    """Pack raw input values in the given input format: uint8 values are
+    rounded and clamped to 0..255."""
+    fmt = INPUT_FORMATS[input_format][1]
+    if fmt == "B":
+        values = [min(max(int(round(v)), 0), 255) for v in values]
+    return struct.pack("<%d%s" % (len(values), fmt), *values)
+
+
+def load_x_bin(path, input_format="model"):
+    """Load the samples of a regression file in the mtb_ml x data layout. Raw
+    input formats need the float x data, whose samples are packed again."""
+    data = load_regression_file(path)
+    x_type, num_samples, input_size, recurrent_ts_size = struct.unpack_from(X_HEADER_FORMAT, data)
+    body = data[struct.calcsize(X_HEADER_FORMAT):]
+    sample_bytes = len(body) // num_samples if num_samples else 0
+    samples = [body[i * sample_bytes:(i + 1) * sample_bytes] for i in range(num_samples)]
+    if input_format != "model":
+        if X_DATA_TYPES.get(x_type) != "f":
+            raise RuntimeError("--input-format %s needs the float x data" % input_format)
+        samples = [pack_raw(struct.unpack("<%df" % (len(s) // 4), s), input_format)
+                   for s in samples]
+    return samples, max(recurrent_ts_size, 0)
+
+
+def group_timesteps(samples, recurrent_ts_size, steps_per_sample):
+    """Split the samples into their time steps (one per sample if they are
+    not sequences), and group them again by steps_per_sample."""
+    count = max(recurrent_ts_size, 1)
+    steps = [sample[i * len(sample) // count:(i + 1) * len(sample) // count]
+             for sample in samples for i in range(count)]
+    return [b"".join(steps[i:i + steps_per_sample])
+            for i in range(0, len(steps) - steps_per_sample + 1, steps_per_sample)]
+
+
+def load_csv(path, data_type, scale, zero_point, input_format="model"):
+    """Load a sample_data CSV: the label, then the inputs of each sample. The
+    inputs are quantized to the data type of the model, value / scale +
+    zero_point, or sent as float, or sent raw in a raw input format. Return
+    the samples and the labels."""
+    fmt = DATA_TYPES[data_type][1]
+    low, high = {"b": (-128, 127), "h": (-32768, 32767)}.get(fmt, (None, None))
+    samples = []
+    labels = []
+    with open(path) as f:
+        for line in f:
+            fields = line.strip().split(",")
+            if len(fields) < 2:
+                continue
+            values = [float(v) for v in fields[1:]]
+            labels.append(int(float(fields[0])))
+            if input_format != "model":
+                samples.append(pack_raw(values, input_format))
+                continue
+            if low is not None:
+                values = [min(max(int(round(v / scale)) + zero_point, low), high)
+                          for v in values]
+            samples.append(struct.pack("<%d%s" % (len(values), fmt), *values))
+    return samples, labels
+
+
+def top_classes(session, result, count=1):
+    """Indices of the count largest outputs of a result, largest first (the
+    first ones on ties)."""
+    if session["top_k"]:
+        return [index for index, _ in result[:count]]
+    fmt = DATA_TYPES[session["data_type"]][1]
+    values = struct.unpack("<%d%s" % (session["output_size"], fmt), result)
+    return sorted(range(len(values)), key=lambda i: (-values[i], i))[:count]
+
+
+def reference_classes(y_data, data_type, output_size, count):
+    """Index of the largest reference output of each sample of the y data."""
+    fmt = DATA_TYPES[data_type][1]
+    size = output_size * struct.calcsize(fmt)
+    classes = []
+    for i in range(count):
+        values = struct.unpack_from("<%d%s" % (output_size, fmt), y_data, i * size)
+        classes.append(values.index(max(values)))
+    return classes
+
+
+def spawn_device(command):
+    """Start the native build of the device on a pty and return the process
+    and the pty. Its log is copied to stdout, the stack lines of its reports
+    are queued in process.stack_reports as (name, size, peak), and the input
+    tensor lines in process.in_place_reports as (in place, samples)."""
+    process = subprocess.Popen(command, stdout=subprocess.PIPE)
+    process.stack_reports = queue.Queue()
+    process.in_place_reports = queue.Queue()
+    for line in iter(process.stdout.readline, b""):
+        match = re.search(rb"Stream port: (\S+)", line)
+        if match:
+            break
+    else:
+        raise RuntimeError("the device did not report its stream port")
+
+    def copy_log():
+        for line in iter(process.stdout.readline, b""):
+            sys.stdout.write(line.decode("utf-8", "replace"))
+            sys.stdout.flush()
+            stack = re.search(rb"stack (\S+): size=(\d+) peak=(\d+)", line)
+            if stack:
+                process.stack_reports.put((stack.group(1).decode(), int(stack.group(2)),
+                                           int(stack.group(3))))
+            in_place = re.search(rb"input tensor: (\d+) of (\d+) samples written in place", line)
+            if in_place:
+                process.in_place_reports.put((int(in_place.group(1)), int(in_place.group(2))))
+
+    threading.Thread(target=copy_log, daemon=True).start()
+    return process, match.group(1).decode()
+
+
+def run_session(link, samples, recurrent_ts_size, window, batch, codec, top_k, timeout,
+                input_format="model", rnn_stateful=False):
+    """Stream the samples and return a dict with the results (raw outputs, or
+    lists of (class, score) with top_k), the elapsed seconds, the done status,
+    the window, batch size and top_k accepted by the device, the bytes of the
+    samples and of the replies, and the link error counts. A frame lost or
+    corrupted either way is asked again; the session only fails if the device
+    stays silent for the timeout. With a raw input format, the device
+    quantizes the samples itself. With rnn_stateful, the device keeps the
+    RNN state from one sample to the next."""
+    session = struct.pack(SESSION_FORMAT, len(samples), recurrent_ts_size, batch, window, codec,
+                          top_k, INPUT_FORMATS[input_format][0], int(rnn_stateful))
+    crc_errors = link.crc_errors
+    deadline = time.monotonic() + timeout
+    frame = None
+    while frame is None:
+        if time.monotonic() > deadline:
+            raise RuntimeError("no answer from the device")
+        link.send(FRAME_SESSION, 0, session)
+        frame = link.receive(RETRANSMIT_TIMEOUT)
+        while frame is not None and frame[0] != FRAME_INFO:
+            frame = link.receive(RETRANSMIT_TIMEOUT)
+
+    version = struct.unpack_from("<H", frame[3])[0]
+    if version != VERSION:
+        raise RuntimeError("unsupported protocol version %d" % version)
+    (_, data_type, elem_size, sample_size, output_size, window, batch, codec, top_k,
+     format_value, input_scale, input_zero_point, stateful) = struct.unpack_from(INFO_FORMAT, frame[3])
+    if format_value != INPUT_FORMATS[input_format][0]:
+        raise RuntimeError("the device does not take %s inputs" % input_format)
+    if stateful != int(rnn_stateful):
+        raise RuntimeError("the device is not built for stateful RNN streaming")
+    raw_fmt = INPUT_FORMATS[input_format][1]
+    sample_bytes = sample_size * (struct.calcsize(raw_fmt) if raw_fmt else elem_size)
+    reply_bytes = top_k * TOP_K_ENTRY_SIZE if top_k else output_size * elem_size
+    link.max_payload = max(MAX_CONTROL_SIZE, reply_bytes * batch)
+    codec_name = [name for name, value in CODECS.items() if value == codec][0]
+    print("Session: %d samples, %s x %d in, %d out, window %d, batch %d, codec %s, top-k %d" %
+          (len(samples), DATA_TYPES.get(data_type, ("?", ""))[0], sample_size, output_size,
+           window, batch, codec_name, top_k))
+    if raw_fmt:
+        print("Input: %s, quantized by the device (scale %g, zero point %d)" %
+              (input_format, input_scale, input_zero_point))
+    if recurrent_ts_size:
+        print("RNN: %d time steps per sample, %s" %
+              (recurrent_ts_size, "state kept across samples" if stateful else "reset per sample"))
+
+    for i, sample in enumerate(samples):
+        if len(sample) != sample_bytes:
+            raise RuntimeError("sample %d has %d bytes, the device expects %d" %
+                               (i, len(sample), sample_bytes))
+    encoded = [encode_sample(codec, sample) for sample in samples]
+    wire_bytes = sum(len(e) for e in encoded)
+
+    num_samples = len(samples)
+    results = [None] * num_samples
+    sent = 0
+    # First sample without a result, and the last one asked again
+    missing = 0
+    missing_nak = None
+    rx_bytes = 0
+    resends = 0
+    naks = 0
+    status = None
+    start = time.monotonic()
+    last_frame = start
+    # Payload of the frames not acked yet, by first sample
+    unacked = {}
+    while status is None or (status == 0 and missing < num_samples):
+        # Keep the window full, but no more than a window past the first
+        # missing result: the device only keeps that many to send again
+        while (sent < num_samples and len(unacked) < window and
+               sent - missing < window * batch):
+            count = min(batch, num_samples - sent)
+            unacked[sent] = (count, b"".join(encoded[sent:sent + count]))
+            link.send(FRAME_SAMPLE, sent, unacked[sent][1])
+            sent += count
+
+        frame = link.receive(RETRANSMIT_TIMEOUT)
+        now = time.monotonic()
+        if frame is None:
+            if now - last_frame > timeout:
+                raise RuntimeError("timeout after %d results" % missing)
+            # Nothing from the device: ask for the first missing reply
+            if missing < sent:
+                link.send(FRAME_NAK, missing, struct.pack(NAK_FORMAT, FRAME_RESULT))
+            else:
+                link.send(FRAME_NAK, 0, struct.pack(NAK_FORMAT, FRAME_DONE))
+            naks += 1
+            continue
+        last_frame = now
+        frame_type, seq, ack, payload = frame
+
+        # The ack is cumulative: it frees every frame ending at or before it
+        for first in sorted(unacked):
+            if ((ack - (first + unacked[first][0])) & 0xFFFF) >= 0x8000:
+                break
+            del unacked[first]
+
+        if frame_type == FRAME_RESULT:
+            rx_bytes += len(payload)
+            distance = (seq - missing) & 0xFFFF
+            if distance >= 0x8000:
+                # Sent again, but already received
+                continue
+            for i, offset in enumerate(range(0, len(payload), reply_bytes)):
+                index = missing + distance + i
+                if index < num_samples and results[index] is None:
+                    reply = payload[offset:offset + reply_bytes]
+                    if top_k:
+                        reply = [struct.unpack_from(TOP_K_ENTRY_FORMAT, reply, k * TOP_K_ENTRY_SIZE)
+                                 for k in range(top_k)]
+                    results[index] = reply
+            if distance and missing_nak != missing:
+                # A reply is missing before this one
+                link.send(FRAME_NAK, missing, struct.pack(NAK_FORMAT, FRAME_RESULT))
+                missing_nak = missing
+                naks += 1
+            while missing < num_samples and results[missing] is not None:
+                missing += 1
+        elif frame_type == FRAME_NAK:
+            wanted, = struct.unpack_from(NAK_FORMAT, payload)
+            for first, (_, data) in unacked.items():
+                if wanted == FRAME_SAMPLE and (first & 0xFFFF) == seq:
+                    link.send(FRAME_SAMPLE, first, data)
+                    resends += 1
+                    break
+        elif frame_type == FRAME_DONE:
+            status, _ = struct.unpack_from(DONE_FORMAT, payload)
+    elapsed = time.monotonic() - start
+
+    # Let the log printed before DONE through
+    link.receive(0.1)
+    return {"results": results, "elapsed": elapsed, "status": status, "window": window,
+            "batch": batch, "top_k": top_k, "wire_bytes": wire_bytes, "reply_bytes": rx_bytes,
+            "data_type": data_type, "output_size": output_size,
+            "crc_errors": link.crc_errors - crc_errors, "resends": resends, "naks": naks}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("port", nargs="?", help="serial port or pty of the device")
+    parser.add_argument("--spawn", metavar="CMD",
+                        help="start the native build of the device on a pty instead")
+    parser.add_argument("--baud", type=int, default=1000000, help="baud rate of a serial port")
+    parser.add_argument("--x-bin", help="regression samples in the mtb_ml x data layout (.bin or .c)")
+    parser.add_argument("--y-bin", help="reference outputs of the regression samples (.bin or .c)")
+    parser.add_argument("--csv", help="sample_data CSV: the label, then the inputs of each sample")
+    parser.add_argument("--csv-type", choices=["int8", "int16", "float"], default="int8",
+                        help="input data type of the model the CSV is sent to")
+    parser.add_argument("--input-scale", type=float, default=1.0,
+                        help="quantization scale of the CSV inputs")
+    parser.add_argument("--input-zero-point", type=int,
+                        help="quantization zero point of the CSV inputs (default -128 for int8, 0 otherwise)")
+    parser.add_argument("--input-format", choices=["model", "uint8", "float"], default="model",
+                        help="send the samples in the data type of the model, or raw uint8 or float "
+                             "values for the device to quantize (needs the float x data or a CSV)")
+    parser.add_argument("--rnn-ts", type=int, metavar="T",
+                        help="RNN: regroup the time steps of the samples into sequences of T steps")
+    parser.add_argument("--rnn-stride", type=int, metavar="S",
+                        help="RNN: stream the time steps S at a time, the device keeping its state")
+    parser.add_argument("--check-replay", type=int, metavar="N",
+                        help="with --rnn-stride, check that the first N results match a replay "
+                             "of all the time steps up to them")
+    parser.add_argument("--random", type=int, metavar="N", help="send N random samples")
+    parser.add_argument("--sample-bytes", type=int, default=784,
+                        help="size of the random samples in bytes")
+    parser.add_argument("--window", type=int, default=0,
+                        help="frames outstanding (default: chosen by the device, 1: stop-and-wait)")
+    parser.add_argument("--batch", type=int, default=1, help="samples per frame")
+    parser.add_argument("--codec", choices=sorted(CODECS), default="none",
+                        help="compression of the samples")
+    parser.add_argument("--top-k", type=int, default=0,
+                        help="reply with the K top classes instead of the full outputs")
+    parser.add_argument("--sweep-batch", metavar="K,K,...",
+                        help="run one session per batch size and print samples/s versus K")
+    parser.add_argument("--sweep-window", metavar="W,W,...",
+                        help="run one session per window and print samples/s versus W")
+    parser.add_argument("--min-accuracy", type=float, metavar="PCT",
+                        help="fail below this accuracy percentage")
+    parser.add_argument("--min-rate", type=float, metavar="N",
+                        help="fail below N samples/s")
+    parser.add_argument("--max-stack", type=int, metavar="BYTES",
+                        help="with --spawn, fail if the device reports no stack peak or a peak "
+                             "above BYTES")
+    parser.add_argument("--check-in-place", action="store_true",
+                        help="with --spawn, fail unless the device ran all the samples but the "
+                             "warm-up one from its input tensor, with the results of a session "
+                             "run from its receive buffers")
+    parser.add_argument("--check-clean-link", action="store_true",
+                        help="fail if a NAK is sent or a frame is sent again, on a line "
+                             "without errors")
+    parser.add_argument("--timeout", type=float, default=10.0, help="timeout in seconds")
+    args = parser.parse_args()
+
+    labels = None
+    if args.x_bin:
+        try:
+            samples, recurrent_ts_size = load_x_bin(args.x_bin, args.input_format)
+        except RuntimeError as error:
+            parser.error(str(error))
+    elif args.csv:
+        data_type = [t for t, (name, _) in DATA_TYPES.items() if name == args.csv_type][0]
+        zero_point = args.input_zero_point
+        if zero_point is None:
+            zero_point = -128 if args.csv_type == "int8" else 0
+        samples, labels = load_csv(args.csv, data_type, args.input_scale, zero_point,
+                                   args.input_format)
+        recurrent_ts_size = 0
+    elif args.random:
+        rng = random.Random(0)
+        samples = [bytes(rng.getrandbits(8) for _ in range(args.sample_bytes))
+                   for _ in range(args.random)]
+        recurrent_ts_size = 0
+    else:
+        parser.error("select the samples with --x-bin, --csv or --random")
+    if args.y_bin and not args.x_bin:
+        parser.error("--y-bin needs --x-bin")
+    if args.rnn_ts or args.rnn_stride:
+        if args.y_bin or labels is not None:
+            parser.error("the references do not match regrouped time steps")
+        samples = group_timesteps(samples, recurrent_ts_size, args.rnn_stride or args.rnn_ts)
+        recurrent_ts_size = args.rnn_stride or args.rnn_ts
+    if args.check_replay and not args.rnn_stride:
+        parser.error("--check-replay needs --rnn-stride")
+    if (args.port is None) == (args.spawn is None):
+        parser.error("give either the port or --spawn")
+    if args.max_stack is not None and not args.spawn:
+        parser.error("--max-stack needs --spawn")
+    if args.check_in_place and not args.spawn:
+        parser.error("--check-in-place needs --spawn")
+
+    device = None
+    port = args.port
+    if args.spawn:
+        device, port = spawn_device(args.spawn.split())
+    try:
+        status = run_sessions(args, port, samples, recurrent_ts_size, labels, device)
+        if args.max_stack is not None and not check_stack(device, args.max_stack, args.timeout):
+            status = 1
+        return status
+    finally:
+        if device is not None:
+            device.terminate()
+            device.wait()
+
+
+def check_stack(device, max_stack, timeout):
+    """Check the stack peak in the report of the first session of a spawned
+    device: painted stack words must have been used, up to max_stack bytes.
+    Return True if it passes."""
+    try:
+        name, size, peak = device.stack_reports.get(timeout=timeout)
+    except queue.Empty:
+        print("FAIL: the device did not report its stack usage")
+        return False
+    print("Stack check: %s peak %d of %d bytes, limit %d" % (name, peak, size, max_stack))
+    if peak == 0 or peak >= size or peak > max_stack:
+        print("FAIL: stack peak out of range")
+        return False
+    return True
+
+
+def check_in_place(link, device, args, samples, recurrent_ts_size, results):
+    """Check the input tensor report of the last session of a spawned device:
+    all the samples but the warm-up one must have been written in the input
+    tensor and run without a copy. With samples in the data type of the
+    model, the results must also be identical to a session of the samples
+    sent uncompressed, which are run from their receive buffers. Return True
+    if it passes."""
+    try:
+        in_place, count = device.in_place_reports.get(timeout=args.timeout)
+    except queue.Empty:
+        print("FAIL: the device did not report its input tensor use")
+        return False
+    print("In-place check: %d of %d samples written in the input tensor" % (in_place, count))
+    if count != len(samples) or in_place + 1 < count:
+        print("FAIL: samples not written in the input tensor")
+        return False
+    if args.input_format == "model":
+        reference = run_session(link, samples, recurrent_ts_size, 0, 1, CODECS["none"], args.top_k,
+                                args.timeout)
+        device.in_place_reports.get(timeout=args.timeout)
+        if reference["results"] != results:
+            print("FAIL: results differ from the samples run from their receive buffers")
+            return False
+    return True
+
+
+def check_replay(link, args, samples, recurrent_ts_size, results):
+    """Compare the results of a stateful RNN session with the replay, from a
+    reset state, of all the time steps up to each of them. Return True if
+    they are identical."""
+    count = min(args.check_replay, len(samples))
+    same = 0
+    for i in range(count):
+        replay = run_session(link, [b"".join(samples[:i + 1])], recurrent_ts_size * (i + 1), 1, 1,
+                             CODECS[args.codec], args.top_k, args.timeout, args.input_format)
+        same += replay["results"][0] == results[i]
+    print("Replay check: %d/%d results identical to the replay" % (same, count))
+    if same != count:
+        print("FAIL: stateful results differ from the replay")
+    return same == count
+
+
+def run_sessions(args, port, samples, recurrent_ts_size, labels, device=None):
+    """Run one session per window and batch size, print the throughput and
+    the accuracy, and return the exit code. device is the spawned device, if
+    any."""
+    y_data = load_regression_file(args.y_bin) if args.y_bin else None
+    link = StreamLink(port, args.baud)
+    batches = [int(k) for k in args.sweep_batch.split(",")] if args.sweep_batch else [args.batch]
+    windows = [int(w) for w in args.sweep_window.split(",")] if args.sweep_window else [args.window]
+    rows = []
+    failed = False
+    for window in windows:
+        for batch in batches:
+            session = run_session(link, samples, recurrent_ts_size, window, batch,
+                                  CODECS[args.codec], args.top_k, args.timeout, args.input_format,
+                                  bool(args.rnn_stride))
+            done = sum(1 for r in session["results"] if r is not None)
+            elapsed = session["elapsed"]
+            rate = done / elapsed if elapsed else 0.0
+            raw_bytes = sum(len(s) for s in samples)
+            wire_bytes = session["wire_bytes"]
+            print("\n%d/%d results in %.3f s: %.1f samples/s, device status %d" %
+                  (done, len(samples), elapsed, rate, session["status"]))
+            print("Sample bytes: %d raw, %d on the wire (%.2f per sample, ratio %.2f)" %
+                  (raw_bytes, wire_bytes, wire_bytes / len(samples) if samples else 0.0,
+                   raw_bytes / wire_bytes if wire_bytes else 0.0))
+            print("Reply bytes: %d (%.2f per sample)" %
+                  (session["reply_bytes"], session["reply_bytes"] / done if done else 0.0))
+            print("Link: %d CRC errors, %d NAKs sent, %d frames sent again" %
+                  (session["crc_errors"], session["naks"], session["resends"]))
+            rows.append((session["window"], session["batch"], rate))
+            failed = failed or session["status"] != 0 or done != len(samples)
+
+            if y_data is not None and labels is None:
+                labels = reference_classes(y_data, session["data_type"],
+                                           session["output_size"], len(samples))
+            if labels is not None and done:
+                # Top-5, or as many classes as the replies hold
+                top_n = min(TOP_N_ACCURACY, session["top_k"] or session["output_size"])
+                ranked = [top_classes(session, result, top_n) if result is not None else []
+                          for result in session["results"]]
+                correct = sum(1 for classes, label in zip(ranked, labels)
+                              if classes and classes[0] == label)
+                correct_n = sum(1 for classes, label in zip(ranked, labels) if label in classes)
+                accuracy = correct * 100.0 / len(samples)
+                print("Accuracy: top-1 %d/%d, %.2f%%; top-%d %d/%d, %.2f%%" %
+                      (correct, len(samples), accuracy, top_n, correct_n, len(samples),
+                       correct_n * 100.0 / len(samples)))
+                if args.min_accuracy is not None and accuracy < args.min_accuracy:
+                    print("FAIL: accuracy below %.2f%%" % args.min_accuracy)
+                    failed = True
+            if args.min_rate is not None and rate < args.min_rate:
+                print("FAIL: throughput below %.1f samples/s" % args.min_rate)
+                failed = True
+            if args.check_clean_link and (session["naks"] or session["resends"]):
+                print("FAIL: NAKs or frames sent again on a clean line")
+                failed = True
+            if args.check_replay:
+                failed = not check_replay(link, args, samples, recurrent_ts_size,
+                                          session["results"]) or failed
+            if args.check_in_place:
+                failed = not check_in_place(link, device, args, samples, recurrent_ts_size,
+                                            session["results"]) or failed
+
+    if args.sweep_batch or args.sweep_window:
+        print("\n  W    K  samples/s")
+        for window, batch, rate in rows:
+            print("%3d  %3d  %9.1f" % (window, batch, rate))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
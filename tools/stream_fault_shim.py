@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+################################################################################
+# \file stream_fault_shim.py
+# \version 1.0
+#
+# \brief
+# Fault-injecting link between tools/ml_stream_host.py and a device running
+# the pipelined stream protocol. It opens a new pty for the host and copies
+# the bytes both ways, flipping a random bit of a byte with the given error
+# rate, and dropping bytes with the given drop rate. Use it to check that the
+# CRC and NAK retransmissions let a session complete over a noisy line. With
+# --baud, the bytes are also paced at the rate of a UART (10 bits per byte),
+# to check the timeouts of the protocol against frames that take longer than
+# them to arrive.
+#
+# The device is a serial port or pty, or the command of the native build of
+# the device (tools/host_device), started on its own pty. The shim prints
+# "Stream port: <pty>" like the native build, so it can itself be started
+# with the --spawn option of ml_stream_host.py.
+#
+# Usage:
+#   python3 stream_fault_shim.py /dev/pts/3 --error-rate 1e-4
+#   python3 ml_stream_host.py --x-bin x_data.c \
+#       --spawn "python3 stream_fault_shim.py --error-rate 1e-4 host_device/build/ml_profiler_host"
+#   python3 stream_fault_shim.py /dev/pts/3 --error-rate 0 --baud 1000000
+#
+################################################################################
+# \copyright
+# Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import os
+import random
+import re
+import select
+import signal
+import stat
+import subprocess
+import sys
+import time
+import tty
+
+
+class FaultInjector:
+    """Corrupts and drops bytes of one direction of the link."""
+
+    def __init__(self, name, rng, error_rate, drop_rate):
+        self.name = name
+        self.rng = rng
+        self.error_rate = error_rate
+        self.drop_rate = drop_rate
+        self.bytes = 0
+        self.corrupted = 0
+        self.dropped = 0
+
+    def apply(self, data):
+        out = bytearray()
+        for byte in data:
+            if self.rng.random() < self.drop_rate:
+                self.dropped += 1
+                continue
+            if self.rng.random() < self.error_rate:
+                byte ^= 1 << self.rng.randrange(8)
+                self.corrupted += 1
+            out.append(byte)
+        self.bytes += len(data)
+        return bytes(out)
+
+    def report(self):
+        return "%s: %d bytes, %d corrupted, %d dropped" % (self.name, self.bytes, self.corrupted,
+                                                           self.dropped)
+
+
+class LinePacer:
+    """Delays the bytes of one direction of the link to a UART rate."""
+
+    # Bits on the line per byte: start, 8 data and stop bits
+    BITS_PER_BYTE = 10
+
+    # Bytes written at once, about 1 ms at 1 Mbps
+    CHUNK = 128
+
+    def __init__(self, baud):
+        self.byte_time = self.BITS_PER_BYTE / baud if baud else 0.0
+        self.free_at = 0.0
+
+    def write(self, fd, data):
+        if not self.byte_time:
+            write_all(fd, data)
+            return
+        for offset in range(0, len(data), self.CHUNK):
+            chunk = data[offset:offset + self.CHUNK]
+            now = time.monotonic()
+            if self.free_at > now:
+                time.sleep(self.free_at - now)
+            else:
+                self.free_at = now
+            write_all(fd, chunk)
+            self.free_at += len(chunk) * self.byte_time
+
+
+def open_device(target):
+    """Open the port of the device, or start the device and open its pty.
+    Return the file descriptor and the process, if any."""
+    if os.path.exists(target[0]) and stat.S_ISCHR(os.stat(target[0]).st_mode):
+        process = None
+        port = target[0]
+    else:
+        process = subprocess.Popen(target, stdout=subprocess.PIPE)
+        for line in iter(process.stdout.readline, b""):
+            match = re.search(rb"Stream port: (\S+)", line)
+            if match:
+                break
+        else:
+            raise RuntimeError("the device did not report its stream port")
+        port = match.group(1).decode()
+
+    fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+    if os.isatty(fd):
+        tty.setraw(fd)
+    return fd, process
+
+
+def write_all(fd, data):
+    view = memoryview(data)
+    while view:
+        view = view[os.write(fd, view):]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("device", nargs="+",
+                        help="port of the device, or the command starting the native build")
+    parser.add_argument("--error-rate", type=float, default=1e-4,
+                        help="probability of a bit flip in each byte")
+    parser.add_argument("--drop-rate", type=float, default=0.0,
+                        help="probability of dropping each byte")
+    parser.add_argument("--direction", choices=["both", "to-device", "to-host"], default="both",
+                        help="direction of the faults")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the faults")
+    parser.add_argument("--baud", type=int, default=0,
+                        help="pace both directions at this UART baud rate (default: no pacing)")
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    to_device = FaultInjector("to device", rng,
+                              args.error_rate if args.direction != "to-host" else 0.0,
+                              args.drop_rate if args.direction != "to-host" else 0.0)
+    to_host = FaultInjector("to host", rng,
+                            args.error_rate if args.direction != "to-device" else 0.0,
+                            args.drop_rate if args.direction != "to-device" else 0.0)
+
+    to_device_line = LinePacer(args.baud)
+    to_host_line = LinePacer(args.baud)
+
+    device_fd, process = open_device(args.device)
+
+    # Keep the slave side open and raw, so the host program can come and go
+    host_fd, slave_fd = os.openpty()
+    tty.setraw(slave_fd)
+    sys.stdout.write("Stream port: %s\r\n" % os.ttyname(slave_fd))
+    sys.stdout.flush()
+
+    def stop(signum, frame):
+        raise KeyboardInterrupt
+
+    signal.signal(signal.SIGTERM, stop)
+    inputs = [device_fd, host_fd]
+    if process is not None:
+        inputs.append(process.stdout.fileno())
+    try:
+        while True:
+            ready, _, _ = select.select(inputs, [], [])
+            for fd in ready:
+                try:
+                    data = os.read(fd, 65536)
+                except OSError:
+                    data = b""
+                if fd == device_fd:
+                    to_host_line.write(host_fd, to_host.apply(data))
+                elif fd == host_fd:
+                    to_device_line.write(device_fd, to_device.apply(data))
+                elif data:
+                    # Log of the native build
+                    sys.stdout.write(data.decode("utf-8", "replace"))
+                    sys.stdout.flush()
+                else:
+                    return 1
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sys.stdout.write("\r\nFault shim: %s; %s\r\n" % (to_device.report(), to_host.report()))
+        sys.stdout.flush()
+        if process is not None:
+            process.terminate()
+            process.wait()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+################################################################################
+# \file trace_decode.py
+# \version 1.0
+#
+# \brief
+# Decode the binary trace dumped by the ML profiler (shared_src/trace_buffer.c)
+# into CSV and Chrome/Perfetto trace JSON.
+#
+# Usage:
+#   python3 trace_decode.py capture.bin --csv trace.csv --json trace.json
+#
+# The capture is the raw data received on the debug UART. The text printed
+# before the dump is skipped.
+#
+################################################################################
+# \copyright
+# Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import csv
+import json
+import struct
+import sys
+
+TRACE_MAGIC = b"MLTR"
+TRACE_VERSION = 1
+HEADER_FORMAT = "<4sHHIII"
+RECORD_FORMAT = "<IHH"
+
+# Event IDs, keep in sync with trace_event_id_t in shared_src/trace_buffer.h
+# id: (name, phase, thread)
+EVENTS = {
+    1: ("inference", "B", "compute"),
+    2: ("inference", "E", "compute"),
+    3: ("op", "B", "compute"),
+    4: ("op", "E", "compute"),
+    5: ("stream rx", "B", "uart"),
+    6: ("stream rx", "E", "uart"),
+    7: ("stream tx", "B", "uart"),
+    8: ("stream tx", "E", "uart"),
+}
+
+THREADS = {"compute": 1, "uart": 2}
+
+
+def parse_dump(data, offset=0):
+    """Parse the first trace dump found in data, starting at offset."""
+    start = data.find(TRACE_MAGIC, offset)
+    if start < 0:
+        raise ValueError("no trace dump found")
+
+    header_size = struct.calcsize(HEADER_FORMAT)
+    magic, version, record_size, num_records, num_events, tick_hz = \
+        struct.unpack_from(HEADER_FORMAT, data, start)
+    if version != TRACE_VERSION:
+        raise ValueError("unsupported trace version %d" % version)
+    if record_size != struct.calcsize(RECORD_FORMAT):
+        raise ValueError("unsupported record size %d" % record_size)
+
+    records = []
+    pos = start + header_size
+    for _ in range(num_records):
+        if pos + record_size > len(data):
+            print("warning: trace dump is truncated", file=sys.stderr)
+            break
+        records.append(struct.unpack_from(RECORD_FORMAT, data, pos))
+        pos += record_size
+
+    if num_events > num_records:
+        print("warning: %d oldest events were overwritten" % (num_events - num_records),
+              file=sys.stderr)
+
+    return tick_hz, records
+
+
+def unwrap(records):
+    """Extend the 32-bit timestamps to 64 bits, assuming consecutive events are
+    less than 2^32 ticks apart."""
+    result = []
+    last = None
+    tick = 0
+    for timestamp, event_id, arg in records:
+        if last is not None:
+            tick += (timestamp - last) & 0xFFFFFFFF
+        last = timestamp
+        result.append((tick, event_id, arg))
+    return result
+
+
+def to_us(tick, tick_hz):
+    return tick * 1e6 / tick_hz if tick_hz else float(tick)
+
+
+def event_name(event_id, arg):
+    name = EVENTS.get(event_id, ("event %d" % event_id, "i", "compute"))[0]
+    return "%s %d" % (name, arg)
+
+
+def write_csv(path, events, tick_hz):
+    with open(path, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["tick", "time_us", "event_id", "event", "arg"])
+        for tick, event_id, arg in events:
+            name, phase, _ = EVENTS.get(event_id, ("unknown", "i", ""))
+            writer.writerow([tick, "%.3f" % to_us(tick, tick_hz), event_id,
+                             "%s %s" % (name, "start" if phase == "B" else "end"), arg])
+
+
+def write_chrome_json(path, events, tick_hz):
+    trace = []
+    for thread, tid in THREADS.items():
+        trace.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": tid,
+                      "args": {"name": thread}})
+    for tick, event_id, arg in events:
+        _, phase, thread = EVENTS.get(event_id, ("", "i", "compute"))
+        trace.append({"name": event_name(event_id, arg), "ph": phase,
+                      "ts": to_us(tick, tick_hz), "pid": 0, "tid": THREADS[thread],
+                      "args": {"arg": arg}})
+    with open(path, "w") as f:
+        json.dump({"traceEvents": trace, "displayTimeUnit": "ns"}, f, indent=1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("capture", help="raw capture of the debug UART")
+    parser.add_argument("--csv", help="output CSV file")
+    parser.add_argument("--json", help="output Chrome/Perfetto trace JSON file")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as f:
+        data = f.read()
+
+    tick_hz, records = parse_dump(data)
+    events = unwrap(records)
+
+    print("%d records, tick rate %s" % (len(events), ("%d Hz" % tick_hz) if tick_hz else "unknown"))
+
+    if args.csv:
+        write_csv(args.csv, events, tick_hz)
+    if args.json:
+        write_chrome_json(args.json, events, tick_hz)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+################################################################################
+# \file x_data_compress.py
+# \version 1.0
+#
+# \brief
+# Compress the x regression data generated by the ML Configurator (the
+# mtb_ml_x_file_header_t layout) for the local regression, which then
+# decompresses one sample at a time into a scratch buffer. The firmware uses
+# it with ML_X_DATA_FORMAT=compressed in common.mk; the layout is
+# ml_x_compressed_header_t of shared_src/ml_x_compressed.h.
+#
+# Each sample is encoded on its own with a codec of the pipelined stream
+# (shared_src/stream_codec.h), and the samples are grouped in blocks whose
+# offsets are stored after the header, so any sample can be read by decoding
+# at most one block. When the data has at most 256 distinct values, the
+# samples can also be stored as byte indices into a table of the values
+# (quantized pixels, for instance). By default the codec and table choice
+# giving the smallest data are used.
+#
+# Usage:
+#   python3 x_data_compress.py mtb_ml_regression_data/TEST_MODEL_tflm_x_data_int16x8.c
+#   python3 x_data_compress.py x_data.bin --nn-type float --model-name TEST_MODEL \
+#       --codec zrle --block-size 8 --out-dir mtb_ml_regression_data
+#
+# It writes <MODEL>_tflm_x_compressed_<NN_TYPE>.c/.h, with the
+# <MODEL>_x_compressed_bin array, next to the x data or in --out-dir, and --bin
+# writes the raw layout.
+#
+################################################################################
+# \copyright
+# Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+from ml_stream_host import (CODECS, X_DATA_TYPES, X_HEADER_FORMAT, encode_sample, load_regression_file,
+                            write_regression_c_files)
+
+# Keep in sync with shared_src/ml_x_compressed.h
+COMPRESSED_MAGIC = 0x4B425A58
+COMPRESSED_HEADER_FORMAT = "<IIIIiIIII"
+# Largest number of values in the table: the indices are bytes
+MAX_TABLE_SIZE = 256
+
+FILE_NAME = re.compile(r"(\w+?)_tflm_x_data_(int8x8|int16x8|float)\.(c|bin)$")
+
+
+def value_table(body, elem_size):
+    """Return the distinct elements of the x data, or None if there are too
+    many of them for byte indices."""
+    values = sorted(set(body[i:i + elem_size] for i in range(0, len(body), elem_size)))
+    return values if len(values) <= MAX_TABLE_SIZE else None
+
+
+def compress(x_data, codec, block_size, table=False):
+    """Return the compressed layout of the x data, or None if a table is asked
+    and the data has too many distinct values."""
+    x_type, num_samples, input_size, recurrent_ts_size = struct.unpack_from(X_HEADER_FORMAT, x_data)
+    if x_type not in X_DATA_TYPES:
+        raise RuntimeError("unknown x data type %d" % x_type)
+    elem_size = struct.calcsize(X_DATA_TYPES[x_type])
+    sample_bytes = input_size * elem_size
+    body = x_data[struct.calcsize(X_HEADER_FORMAT):][:num_samples * sample_bytes]
+    if len(body) < num_samples * sample_bytes:
+        raise RuntimeError("%d bytes of x data are not %d samples of %d bytes" %
+                           (len(body), num_samples, sample_bytes))
+
+    values = value_table(body, elem_size) if table else []
+    if values is None:
+        return None
+    if values:
+        index = {value: i for i, value in enumerate(values)}
+        body = bytes(index[body[i:i + elem_size]] for i in range(0, len(body), elem_size))
+        sample_bytes = input_size
+
+    blocks = bytearray()
+    offsets = []
+    for i in range(num_samples):
+        if i % block_size == 0:
+            offsets.append(len(blocks))
+        blocks += encode_sample(codec, body[i * sample_bytes:(i + 1) * sample_bytes])
+    offsets.append(len(blocks))
+
+    data = struct.pack(COMPRESSED_HEADER_FORMAT, COMPRESSED_MAGIC, x_type, num_samples, input_size,
+                       recurrent_ts_size, codec, block_size, len(offsets) - 1, len(values))
+    data += b"".join(values)
+    data += b"\0" * (-len(data) % 4)
+    data += struct.pack("<%dI" % len(offsets), *offsets)
+    data += blocks
+    data += b"\0" * (-len(data) % 4)
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("x_data", help="x regression data (.c file of the ML Configurator or .bin)")
+    parser.add_argument("--nn-type", choices=["int8x8", "int16x8", "float"],
+                        help="data type of the model (default: from the file name)")
+    parser.add_argument("--model-name", help="model name (default: from the file name)")
+    parser.add_argument("--codec", choices=["auto"] + sorted(CODECS), default="auto",
+                        help="codec of the samples, auto for the smallest data")
+    parser.add_argument("--table", choices=["auto", "yes", "no"], default="auto",
+                        help="store the samples as indices into a table of values, auto for the "
+                             "smallest data")
+    parser.add_argument("--block-size", type=int, default=16,
+                        help="samples per block, decoded at most to reach a sample")
+    parser.add_argument("--out-dir", help="directory of the .c/.h files (default: the x data one)")
+    parser.add_argument("--bin", help="also write the raw layout to this file")
+    args = parser.parse_args()
+
+    match = FILE_NAME.search(os.path.basename(args.x_data))
+    nn_type = args.nn_type or (match and match.group(2))
+    model_name = args.model_name or (match and match.group(1))
+    if not nn_type or not model_name:
+        parser.error("--nn-type and --model-name are needed for this file name")
+    if args.block_size <= 0:
+        parser.error("--block-size must be positive")
+
+    x_data = load_regression_file(args.x_data)
+    codecs = sorted(CODECS) if args.codec == "auto" else [args.codec]
+    tables = [False, True] if args.table == "auto" else [args.table == "yes"]
+    candidates = [(compress(x_data, CODECS[name], args.block_size, table), name, table)
+                  for name in codecs for table in tables]
+    candidates = [candidate for candidate in candidates if candidate[0] is not None]
+    if not candidates:
+        parser.error("the x data has more than %d distinct values for a table" % MAX_TABLE_SIZE)
+    data, codec_name, table = min(candidates, key=lambda candidate: len(candidate[0]))
+
+    out_dir = args.out_dir or os.path.dirname(os.path.abspath(args.x_data))
+    path = write_regression_c_files(out_dir, "%s_tflm_x_compressed_%s" % (model_name, nn_type),
+                                    "%s_x_compressed_bin" % model_name, data, "x_data_compress.py",
+                                    os.path.basename(args.x_data),
+                                    "the compressed input data for the %s model in %s representation"
+                                    % (model_name, nn_type))
+    if args.bin:
+        with open(args.bin, "wb") as f:
+            f.write(data)
+
+    print("%s: %s codec%s, %d bytes instead of %d (ratio %.2f)" %
+          (path, codec_name, " with a table of values" if table else "", len(data), len(x_data),
+           len(x_data) / len(data)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+################################################################################
+# \file y_data_to_labels.py
+# \version 1.0
+#
+# \brief
+# Convert the y regression data generated by the ML Configurator (the full
+# output vector of every sample) into label-only y data: the class index of
+# every sample, optionally followed by the reference output of the model for
+# that class, for a tolerance check. The firmware uses it with
+# ML_Y_DATA_FORMAT=labels in common.mk; the layout is ml_y_labels_header_t
+# of shared_src/ml_y_labels.h.
+#
+# The number of outputs per sample is taken from the x data header (the x data
+# file next to the y data by default, or --x-bin), or from --num-classes.
+#
+# Usage:
+#   python3 y_data_to_labels.py mtb_ml_regression_data/TEST_MODEL_tflm_y_data_int8x8.c
+#   python3 y_data_to_labels.py y_data.bin --nn-type float --num-classes 10 --scores \
+#       --model-name TEST_MODEL --out-dir mtb_ml_regression_data
+#
+# It writes <MODEL>_tflm_y_labels_<NN_TYPE>.c/.h, with the <MODEL>_y_labels_bin
+# array, next to the y data or in --out-dir, and --bin writes the raw layout.
+#
+################################################################################
+# \copyright
+# Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+from ml_stream_host import X_HEADER_FORMAT, load_regression_file, write_regression_c_files
+
+# Keep in sync with shared_src/ml_y_labels.h
+LABELS_MAGIC = 0x4C424C59
+LABELS_HEADER_FORMAT = "<IIHBB"
+
+# Struct format of an output element of each NN_TYPE
+NN_TYPES = {"int8x8": "b", "int16x8": "h", "float": "f"}
+
+FILE_NAME = re.compile(r"(\w+?)_tflm_y_data_(int8x8|int16x8|float)\.(c|bin)$")
+
+
+def convert(y_data, fmt, num_classes, scores):
+    """Return the label-only layout of the y data, and the number of samples."""
+    elem_size = struct.calcsize(fmt)
+    sample_bytes = num_classes * elem_size
+    if num_classes <= 0 or len(y_data) % sample_bytes:
+        raise RuntimeError("%d bytes of y data are not samples of %d outputs" %
+                           (len(y_data), num_classes))
+    num_samples = len(y_data) // sample_bytes
+    index_size = 1 if num_classes <= 256 else 2
+
+    labels = []
+    values = []
+    for i in range(num_samples):
+        outputs = struct.unpack_from("<%d%s" % (num_classes, fmt), y_data, i * sample_bytes)
+        # First index of the maximum, like ml_topk()
+        label = outputs.index(max(outputs))
+        labels.append(label)
+        values.append(outputs[label])
+
+    data = struct.pack(LABELS_HEADER_FORMAT, LABELS_MAGIC, num_samples, num_classes, index_size,
+                       elem_size if scores else 0)
+    data += struct.pack("<%d%s" % (num_samples, "B" if index_size == 1 else "H"), *labels)
+    data += b"\0" * (-len(data) % 4)
+    if scores:
+        data += struct.pack("<%d%s" % (num_samples, fmt), *values)
+    return data, num_samples
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("y_data", help="y regression data (.c file of the ML Configurator or .bin)")
+    parser.add_argument("--nn-type", choices=sorted(NN_TYPES),
+                        help="data type of the outputs (default: from the file name)")
+    parser.add_argument("--model-name", help="model name (default: from the file name)")
+    parser.add_argument("--num-classes", type=int, help="outputs per sample")
+    parser.add_argument("--x-bin", help="x regression data giving the number of samples "
+                                        "(default: the x data next to the y data)")
+    parser.add_argument("--scores", action="store_true",
+                        help="keep the reference output of the class of each sample")
+    parser.add_argument("--out-dir", help="directory of the .c/.h files (default: the y data one)")
+    parser.add_argument("--bin", help="also write the raw layout to this file")
+    args = parser.parse_args()
+
+    match = FILE_NAME.search(os.path.basename(args.y_data))
+    nn_type = args.nn_type or (match and match.group(2))
+    model_name = args.model_name or (match and match.group(1))
+    if not nn_type or not model_name:
+        parser.error("--nn-type and --model-name are needed for this file name")
+
+    y_data = load_regression_file(args.y_data)
+    fmt = NN_TYPES[nn_type]
+
+    num_classes = args.num_classes
+    if num_classes is None:
+        x_path = args.x_bin or args.y_data.replace("_y_data_", "_x_data_")
+        if x_path == args.y_data or not os.path.exists(x_path):
+            parser.error("--num-classes or --x-bin is needed")
+        num_samples = struct.unpack_from(X_HEADER_FORMAT, load_regression_file(x_path))[1]
+        num_classes = len(y_data) // struct.calcsize(fmt) // num_samples if num_samples else 0
+
+    data, num_samples = convert(y_data, fmt, num_classes, args.scores)
+
+    out_dir = args.out_dir or os.path.dirname(os.path.abspath(args.y_data))
+    path = write_regression_c_files(out_dir, "%s_tflm_y_labels_%s" % (model_name, nn_type),
+                                    "%s_y_labels_bin" % model_name, data, "y_data_to_labels.py",
+                                    os.path.basename(args.y_data),
+                                    "the reference class of each sample for the %s model in %s "
+                                    "representation" % (model_name, nn_type))
+    if args.bin:
+        with open(args.bin, "wb") as f:
+            f.write(data)
+
+    print("%s: %d samples, %d classes, %d bytes instead of %d (%.1fx smaller)" %
+          (path, num_samples, num_classes, len(data), len(y_data), len(y_data) / len(data)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())